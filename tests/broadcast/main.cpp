@@ -0,0 +1,99 @@
+// The broadcast tests: every client of the channel receives each broadcast buffer exactly once and in order,
+// and the shared buffer is released by all send ops after the data delivered.
+#include <stdio.h>
+#include <thread>
+#include <string>
+
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+static const u_short SERVER_PORT = 18258;
+static const int CLIENT_COUNT    = 4;
+
+static int errors = 0;
+#define CHECK(cond, ...)             \
+  do                                 \
+  {                                  \
+    if (!(cond))                     \
+    {                                \
+      printf("%s: ", #cond);         \
+      printf(__VA_ARGS__);           \
+      printf("\n");                  \
+      ++errors;                      \
+    }                                \
+  } while (false)
+
+template <typename _Pred> static bool wait_until(_Pred&& pred)
+{
+  for (int i = 0; i < 500 && !pred(); ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  return pred();
+}
+
+static std::string recv_string(xxsocket& s, size_t size)
+{
+  std::string data(size, '\0');
+  size_t offset = 0;
+  while (offset < size)
+  {
+    int n = s.recv(&data[offset], static_cast<int>(size - offset));
+    if (n <= 0)
+      break;
+    offset += n;
+  }
+  data.resize(offset);
+  return data;
+}
+
+int main(int, char**)
+{
+  std::atomic<int> opened{0};
+
+  io_hostent host("127.0.0.1", SERVER_PORT);
+  io_service service(&host, 1);
+  service.set_option(YOPT_S_DEFERRED_EVENT, 0);
+  service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+  service.start([&](event_ptr&& ev) {
+    if (ev->kind() == YEK_ON_OPEN && ev->status() == 0 && ev->transport())
+      ++opened;
+  });
+  service.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  xxsocket clients[CLIENT_COUNT];
+  for (auto& client : clients)
+  {
+    client.pconnect("127.0.0.1", SERVER_PORT);
+    client.set_optval(SOL_SOCKET, SO_RCVTIMEO, timeval{5, 0});
+  }
+  CHECK(wait_until([&] { return opened == CLIENT_COUNT; }), "only %d of %d connections opened", opened.load(), CLIENT_COUNT);
+
+  // the large buffer can't be sent by one call, the partial sent offset is per transport
+  std::vector<char> large(1024 * 1024);
+  for (size_t i = 0; i < large.size(); ++i)
+    large[i] = static_cast<char>('a' + i % 26);
+  auto first  = make_shared_buffer(large);
+  auto second = make_shared_buffer(std::vector<char>{'d', 'o', 'n', 'e'});
+  CHECK(service.broadcast(0, first) == static_cast<int>(large.size()), "broadcast the large buffer failed");
+  CHECK(service.broadcast(0, second) == 4, "broadcast the small buffer failed");
+  CHECK(service.broadcast(-1, second) < 0, "broadcast to the invalid channel accepted");
+
+  const std::string expected = std::string(large.data(), large.size()) + "done";
+  for (int i = 0; i < CLIENT_COUNT; ++i)
+  {
+    CHECK(recv_string(clients[i], expected.size()) == expected, "the client %d received unexpected data", i);
+    // no more data, the broadcast not delivered twice
+    clients[i].set_optval(SOL_SOCKET, SO_RCVTIMEO, timeval{0, 100000});
+    char extra = 0;
+    CHECK(clients[i].recv(&extra, 1) <= 0, "the client %d received the data more than once", i);
+  }
+
+  CHECK(wait_until([&] { return first.use_count() == 1 && second.use_count() == 1; }),
+        "the shared buffers not released by send ops, use_count: %ld, %ld", first.use_count(), second.use_count());
+
+  service.stop();
+  printf("broadcast tests: %s, errors=%d\n", errors ? "FAILED" : "PASSED", errors);
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+// The frame decoder microbenchmark: the runtime configured length field decoder called through std::function
+// like io_channel::decode_len_ does, vs the compile-time specialized fixed_length_field called through function pointer.
+#include <stdio.h>
+#include <vector>
+
+#include "yasio/yasio.hpp"
+#include "yasio/obstream.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+static const int FRAMES = 10000000;
+
+// The unpack params set by YOPT_C_UNPACK_PARAMS, same as io_channel::__builtin_decode_len
+struct unpack_params {
+  int max_frame_length    = YASIO_SZ(10, M);
+  int length_field_offset = 2;
+  int length_field_length = 4;
+  int length_adjustment   = 6;
+};
+static int runtime_decode_len(const unpack_params& uparams, void* d, int n)
+{
+  int loffset = uparams.length_field_offset;
+  int lsize   = uparams.length_field_length;
+  if (loffset >= 0)
+  {
+    int len = 0;
+    if (n >= (loffset + lsize))
+    {
+      ::memcpy(&len, (uint8_t*)d + loffset, lsize);
+      len = yasio::network_to_host(len, lsize);
+      len += uparams.length_adjustment;
+      if (len > uparams.max_frame_length)
+        len = -1;
+    }
+    return len;
+  }
+  return n;
+}
+
+template <typename _Fn> static long long bench(const char* name, const std::vector<char>& frames, _Fn&& decode_len)
+{
+  long long total = 0;
+  auto start      = highp_clock();
+  for (int i = 0; i < FRAMES; ++i)
+  {
+    int length = decode_len((void*)frames.data(), static_cast<int>(frames.size()));
+    if (length <= 0)
+      return -1;
+    total += length;
+  }
+  auto elapsed = highp_clock() - start;
+  printf("%-32s frames=%d elapsed=%lldms, %.2fns/frame\n", name, FRAMES, elapsed / 1000, elapsed * 1000.0 / FRAMES);
+  return total;
+}
+
+int main(int, char**)
+{
+  // header: 2 bytes magic, 4 bytes length of body
+  obstream obs;
+  obs.write<uint16_t>(0x5a5a);
+  obs.write<int32_t>(128);
+  obs.write_bytes(std::string(128, 'x'));
+  auto& frames = obs.buffer();
+
+  unpack_params uparams;
+  decode_len_fn_t fn = [&](void* d, int n) { return runtime_decode_len(uparams, d, n); };
+  // store to volatile like io_channel::decode_len_fp_, avoid compiler inlines the call at bench site
+  decode_len_fp_t volatile fp = &fixed_length_field<2, 4, yasio::network_convert_tag, 6>::decode_len;
+
+  auto expected = bench("std::function + runtime params", frames, fn);
+  auto actual   = bench("fixed_length_field<2, 4, 6>", frames, [&](void* d, int n) { return fp(d, n); });
+  if (expected != actual || expected != FRAMES * static_cast<long long>(frames.size()))
+  {
+    printf("the decoded lengths mismatch: %lld vs %lld\n", expected, actual);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,143 @@
+//
+// Reports the resident memory cost of idle tcp connections, both ends of each connection live in this process.
+// usage: idletest [connections], build with YASIO_ENABLE_SHARED_RECV_BUFFER to compare.
+//
+#include "yasio/yasio.hpp"
+#include "yasio/obstream.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#  include <psapi.h>
+#  pragma comment(lib, "psapi.lib")
+#elif defined(__APPLE__)
+#  include <mach/mach.h>
+#  include <sys/resource.h>
+#else
+#  include <unistd.h>
+#  include <sys/resource.h>
+#endif
+
+using namespace yasio;
+
+#define IDLETEST_PORT 23461
+#define IDLETEST_BATCH 16 // less than YASIO_SOMAXCONN
+
+static long long resident_bytes()
+{
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS pmc;
+  return GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) ? static_cast<long long>(pmc.WorkingSetSize) : -1;
+#elif defined(__APPLE__)
+  mach_task_basic_info info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  return task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS ? static_cast<long long>(info.resident_size) : -1;
+#else
+  long long pages = 0, resident = 0;
+  FILE* fp        = fopen("/proc/self/statm", "r");
+  if (!fp)
+    return -1;
+  int n = fscanf(fp, "%lld %lld", &pages, &resident);
+  fclose(fp);
+  return n == 2 ? resident * sysconf(_SC_PAGESIZE) : -1;
+#endif
+}
+
+static void raise_fd_limit()
+{
+#if !defined(_WIN32)
+  struct rlimit rl;
+  if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max)
+  {
+    rl.rlim_cur = rl.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rl);
+  }
+#endif
+}
+
+template <typename _Pred> static bool wait_until(_Pred pred, int timeout_ms)
+{
+  auto deadline = highp_clock<steady_clock_t>() + timeout_ms * 1000LL;
+  while (!pred())
+  {
+    if (highp_clock<steady_clock_t>() > deadline)
+      return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  const int total = argc > 1 ? atoi(argv[1]) : 1000;
+  raise_fd_limit();
+
+  std::atomic<int> accepted{0}, received{0}, connected{0}, failed{0};
+
+  io_hostent server_ep{"127.0.0.1", IDLETEST_PORT};
+  io_service server(&server_ep, 1);
+  server.set_option(YOPT_S_DEFERRED_EVENT, 0);
+  server.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+  server.set_option(YOPT_C_LFBFD_PARAMS, 0, 65535, 0, 4, 4);
+  server.start([&](event_ptr&& ev) {
+    if (ev->kind() == YEK_ON_OPEN && ev->status() == 0)
+      ++accepted;
+    else if (ev->kind() == YEK_ON_PACKET)
+      ++received;
+  });
+  server.open(0, YCK_TCP_SERVER);
+
+  std::vector<io_hostent> client_eps(total, io_hostent{"127.0.0.1", IDLETEST_PORT});
+  io_service client(client_eps);
+  client.set_option(YOPT_S_DEFERRED_EVENT, 0);
+  client.start([&](event_ptr&& ev) {
+    if (ev->kind() == YEK_ON_OPEN)
+    {
+      if (ev->status() == 0)
+      { // every connection transfer a small frame once, then keep idle
+        obstream obs;
+        obs.push32();
+        obs.write_bytes("hello");
+        obs.pop32();
+        client.write(ev->transport(), std::move(obs.buffer()));
+        ++connected;
+      }
+      else
+        ++failed;
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  auto rss_before = resident_bytes();
+  auto start      = highp_clock();
+  for (int i = 0; i < total; i += IDLETEST_BATCH)
+  {
+    int end = (std::min)(i + IDLETEST_BATCH, total);
+    for (int k = i; k < end; ++k)
+      client.open(k, YCK_TCP_CLIENT);
+    if (!wait_until([&] { return connected + failed >= end && accepted >= connected; }, 10000))
+      break;
+  }
+  wait_until([&] { return received >= connected; }, 10000);
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  auto rss_after = resident_bytes();
+
+  int conns = (std::min)(connected.load(), accepted.load());
+  printf("connections: %d/%d, failed: %d, received: %d, cost: %.3lf(s)\n", conns, total, failed.load(), received.load(), (highp_clock() - start) / 1000000.0);
+#if defined(YASIO_ENABLE_SHARED_RECV_BUFFER)
+  printf("recv buffer: shared by io_service\n");
+#else
+  printf("recv buffer: inline %d bytes per transport\n", YASIO_INET_BUFFER_SIZE);
+#endif
+  if (rss_before > 0 && rss_after > 0 && conns > 0)
+  {
+    auto delta = rss_after - rss_before;
+    printf("resident: %lld -> %lld bytes, %lld bytes per idle connection (%lld per transport)\n", rss_before, rss_after, delta / conns, delta / (conns * 2));
+  }
+  else
+    printf("resident: unavailable\n");
+
+  client.stop();
+  server.stop();
+  return conns == total ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+// The send queue microbenchmark: N producer threads write io_send_op, one consumer thread
+// peek/pop them like io_transport::do_write does.
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+#if defined(YASIO_USE_SPSC_QUEUE)
+static const char* locked_queue_name = "moodycamel spsc";
+#else
+static const char* locked_queue_name = "std::queue + mutex";
+#endif
+
+static const int OPS_PER_PRODUCER = 1000000;
+
+template <typename _Queue, typename _Peek> static void bench(const char* name, int producers, _Peek&& peek_and_pop)
+{
+  _Queue queue;
+  std::atomic<int> ready{0};
+  std::vector<std::thread> threads;
+
+  auto start = highp_clock();
+  for (int i = 0; i < producers; ++i)
+    threads.emplace_back([&] {
+      ++ready;
+      while (ready < producers)
+        std::this_thread::yield();
+      for (int n = 0; n < OPS_PER_PRODUCER; ++n)
+        queue.emplace(cxx14::make_unique<io_send_op>(std::vector<char>{}, nullptr));
+    });
+
+  const int total = producers * OPS_PER_PRODUCER;
+  for (int consumed = 0; consumed < total;)
+  {
+    if (peek_and_pop(queue))
+      ++consumed;
+  }
+  auto elapsed = highp_clock() - start;
+  for (auto& t : threads)
+    t.join();
+
+  printf("%-20s producers=%d ops=%d elapsed=%lldms, %.1fns/op\n", name, producers, total, elapsed / 1000, elapsed * 1000.0 / total);
+}
+
+int main(int, char**)
+{
+  typedef privacy::mpsc_queue<io_send_op> mpsc_queue_t;
+  typedef privacy::concurrent_queue<send_op_ptr> locked_queue_t;
+
+  for (int producers : {1, 2, 4, 8})
+  {
+    bench<mpsc_queue_t>("lock-free mpsc", producers, [](mpsc_queue_t& q) {
+      if (q.peek())
+      {
+        q.pop();
+        return true;
+      }
+      return false;
+    });
+
+#if defined(YASIO_USE_SPSC_QUEUE)
+    if (producers > 1)
+      continue; // the spsc queue doesn't support multi producers
+#endif
+    bench<locked_queue_t>(locked_queue_name, producers, [](locked_queue_t& q) {
+      auto wrap = q.peek();
+      if (wrap)
+      {
+        (*wrap).reset();
+        q.pop();
+        return true;
+      }
+      return false;
+    });
+  }
+
+  return 0;
+}
@@ -30,6 +30,15 @@ Test detail, please see: https://github.com/yasio/yasio/blob/master/benchmark.md
 
 #define SPEEDTEST_TRANSFER_PROTOCOL SPEEDTEST_PROTO_KCP
 
+// linux only, transfer udp/kcp with UDP_SEGMENT and UDP_GRO, the packet must not exceed path mtu
+#define SPEEDTEST_UDP_GSO 0
+
+#if SPEEDTEST_UDP_GSO
+#  define SPEEDTEST_PACKET_SIZE 1400
+#else
+#  define SPEEDTEST_PACKET_SIZE YASIO_SZ(62, k)
+#endif
+
 #if SPEEDTEST_TRANSFER_PROTOCOL == SPEEDTEST_PROTO_TCP
 #  define SPEEDTEST_DEFAULT_KIND YCK_TCP_CLIENT
 #elif SPEEDTEST_TRANSFER_PROTOCOL == SPEEDTEST_PROTO_UDP
@@ -127,7 +136,9 @@ static void print_speed_detail(double interval, double time_elapsed)
 void setup_kcp_transfer(transport_handle_t handle)
 {
   auto kcp_handle = static_cast<io_transport_kcp*>(handle)->internal_object();
+#if !SPEEDTEST_UDP_GSO
   ::ikcp_setmtu(kcp_handle, YASIO_SZ(63, k));
+#endif
   ::ikcp_wndsize(kcp_handle, 4096, 8192);
 }
 
@@ -196,7 +207,7 @@ void kcp_send_repeated(io_service* service, transport_handle_t thandle, obstream
 
 void start_sender(io_service& service)
 {
-  static const int PER_PACKET_SIZE = YASIO_SZ(62, k);
+  static const int PER_PACKET_SIZE = SPEEDTEST_PACKET_SIZE;
   static char buffer[PER_PACKET_SIZE];
   static obstream obs;
   obs.write_bytes(buffer, PER_PACKET_SIZE);
@@ -250,6 +261,10 @@ void start_sender(io_service& service)
   service.set_option(YOPT_C_KCP_CONV, 0, s_kcp_conv);
 #endif
 
+#if SPEEDTEST_UDP_GSO && SPEEDTEST_TRANSFER_PROTOCOL != SPEEDTEST_PROTO_TCP
+  service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_UDP_GSO, 0);
+#endif
+
   service.open(0, speedtest::SENDER_CHANNEL_KIND);
 }
 
@@ -299,6 +314,10 @@ void start_receiver(io_service& service)
   service.set_option(YOPT_C_KCP_CONV, 0, s_kcp_conv);
 #endif
 
+#if SPEEDTEST_UDP_GSO && SPEEDTEST_TRANSFER_PROTOCOL != SPEEDTEST_PROTO_TCP
+  service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_UDP_GSO, 0);
+#endif
+
   service.open(0, speedtest::RECEIVER_CHANNEL_KIND);
 }
 
@@ -0,0 +1,127 @@
+// The timing wheel tests: the nodes expire exactly at their ticks, including the ones cascaded
+// from upper levels (beyond 64 and 4096 ticks) and the rescheduled ones.
+#include <stdio.h>
+#include <vector>
+
+#include "yasio/detail/timing_wheel.hpp"
+
+using namespace yasio;
+
+struct test_node : public wheel_node {
+  int id = 0;
+};
+
+static int errors = 0;
+#define CHECK(cond, ...)             \
+  do                                 \
+  {                                  \
+    if (!(cond))                     \
+    {                                \
+      printf("%s: ", #cond);         \
+      printf(__VA_ARGS__);           \
+      printf("\n");                  \
+      ++errors;                      \
+    }                                \
+  } while (false)
+
+// advance tick by tick, all nodes must expire at their expire tick, the due nodes are popped in insert order
+static void check_expire_exactly(timing_wheel& wheel, highp_time_t until, size_t expected)
+{
+  size_t expired = 0;
+  for (highp_time_t tick = wheel.current_tick() + 1; tick <= until; ++tick)
+  {
+    wheel.advance(tick);
+    int last_id = -1;
+    while (auto node = static_cast<test_node*>(wheel.pop_due()))
+    {
+      CHECK(node->expire_tick_ == tick, "node #%d expire at %lld, but popped at %lld", node->id, node->expire_tick_, tick);
+      CHECK(node->id > last_id, "node #%d popped after #%d at same tick", node->id, last_id);
+      last_id = node->id;
+      ++expired;
+    }
+  }
+  CHECK(expired == expected, "expired %zu nodes, expected %zu", expired, expected);
+}
+
+static void test_cascade()
+{
+  // the level boundaries: 64 ticks of level 0, 4096 ticks of level 1, 262144 ticks of level 2
+  const highp_time_t ticks[] = {1, 63, 64, 65, 127, 128, 4095, 4096, 4097, 8191, 8192, 262143, 262144, 262145};
+  const int count            = static_cast<int>(sizeof(ticks) / sizeof(ticks[0]));
+  timing_wheel wheel;
+  std::vector<test_node> nodes(count * 2);
+  for (int i = 0; i < count * 2; ++i)
+  { // insert twice each tick, they must expire at same tick in insert order
+    nodes[i].id = i;
+    wheel.insert(&nodes[i], ticks[i / 2]);
+  }
+  CHECK(wheel.size() == nodes.size(), "size %zu", wheel.size());
+  CHECK(wheel.next_tick() == 1, "next_tick %lld", wheel.next_tick());
+  check_expire_exactly(wheel, 262145 + 64, nodes.size());
+  CHECK(wheel.empty() && wheel.next_tick() == -1, "the wheel not empty, size %zu", wheel.size());
+}
+
+static void test_jump()
+{
+  // advance far away at once like io_service wakes up late, the expired nodes all go to due list
+  timing_wheel wheel;
+  std::vector<test_node> nodes(1000);
+  uint32_t seed = 1;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    seed        = seed * 1103515245 + 12345;
+    nodes[i].id = static_cast<int>(i);
+    wheel.insert(&nodes[i], 1 + (seed >> 8) % 300000);
+  }
+  for (highp_time_t target = 0; !wheel.empty() && target < 300000 + 4000;)
+  {
+    target += 4000; // not aligned to level boundaries
+    CHECK(wheel.next_tick() > wheel.current_tick(), "next_tick %lld <= current tick %lld", wheel.next_tick(), wheel.current_tick());
+    wheel.advance(target);
+    CHECK(wheel.current_tick() == target, "current tick %lld, expected %lld", wheel.current_tick(), target);
+    while (auto node = static_cast<test_node*>(wheel.pop_due()))
+      CHECK(node->expire_tick_ <= target && node->expire_tick_ > target - 4000, "node #%d expire at %lld, popped at %lld", node->id, node->expire_tick_,
+            target);
+  }
+  CHECK(wheel.empty(), "%zu nodes never expired", wheel.size());
+}
+
+static void test_reschedule()
+{
+  timing_wheel wheel;
+  std::vector<test_node> nodes(4);
+  for (int i = 0; i < 4; ++i)
+    nodes[i].id = i;
+  wheel.insert(&nodes[0], 5000);
+  wheel.insert(&nodes[1], 70);
+  wheel.insert(&nodes[2], 10);
+  wheel.insert(&nodes[3], 300000);
+
+  wheel.advance(50);
+  // reschedule the cascaded and uncascaded nodes, like highp_timer::async_wait on a pending timer
+  wheel.remove(&nodes[0]);
+  wheel.insert(&nodes[0], 60);
+  wheel.remove(&nodes[1]);
+  wheel.insert(&nodes[1], 4200);
+  wheel.remove(&nodes[3]);
+  CHECK(!nodes[3].linked() && wheel.size() == 3, "size %zu", wheel.size());
+
+  auto node = static_cast<test_node*>(wheel.pop_due());
+  CHECK(node == &nodes[2], "the node expire at 10 not popped at 50");
+  CHECK(wheel.pop_due() == nullptr, "unexpected due node");
+  check_expire_exactly(wheel, 5000 + 64, 2);
+  CHECK(wheel.empty(), "the wheel not empty, size %zu", wheel.size());
+
+  // insert a expired node, it's due immediately
+  wheel.insert(&nodes[3], wheel.current_tick() - 1);
+  CHECK(wheel.next_tick() == wheel.current_tick() && wheel.pop_due() == &nodes[3], "the expired node not due");
+}
+
+int main(int, char**)
+{
+  test_cascade();
+  test_jump();
+  test_reschedule();
+  printf("timing_wheel tests: %s, errors=%d\n", errors ? "FAILED" : "PASSED", errors);
+  return errors ? 1 : 0;
+}
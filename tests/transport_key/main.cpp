@@ -0,0 +1,106 @@
+// The transport key tests: the key of closed transport is rejected, even the slot and the transport memory are
+// reused by next connection, and the closed transport handle is ignored by io_service::close.
+#include <stdio.h>
+#include <thread>
+#include <string>
+
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+static const u_short SERVER_PORT = 18257;
+
+static int errors = 0;
+#define CHECK(cond, ...)             \
+  do                                 \
+  {                                  \
+    if (!(cond))                     \
+    {                                \
+      printf("%s: ", #cond);         \
+      printf(__VA_ARGS__);           \
+      printf("\n");                  \
+      ++errors;                      \
+    }                                \
+  } while (false)
+
+template <typename _Pred> static bool wait_until(_Pred&& pred)
+{
+  for (int i = 0; i < 500 && !pred(); ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  return pred();
+}
+
+static std::string recv_string(xxsocket& s, size_t size)
+{
+  std::string data(size, '\0');
+  size_t offset = 0;
+  while (offset < size)
+  {
+    int n = s.recv(&data[offset], static_cast<int>(size - offset));
+    if (n <= 0)
+      break;
+    offset += n;
+  }
+  data.resize(offset);
+  return data;
+}
+
+int main(int, char**)
+{
+  std::atomic<int> opened{0}, closed{0};
+  std::atomic<transport_key_t> key{0};
+  std::atomic<transport_handle_t> handle{nullptr};
+
+  io_hostent host("127.0.0.1", SERVER_PORT);
+  io_service service(&host, 1);
+  service.set_option(YOPT_S_DEFERRED_EVENT, 0);
+  service.start([&](event_ptr&& ev) {
+    if (ev->kind() == YEK_ON_OPEN && ev->status() == 0 && ev->transport())
+    {
+      key    = ev->transport_key();
+      handle = ev->transport();
+      ++opened;
+    }
+    else if (ev->kind() == YEK_ON_CLOSE)
+      ++closed;
+  });
+  service.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  xxsocket first;
+  first.pconnect("127.0.0.1", SERVER_PORT);
+  first.set_optval(SOL_SOCKET, SO_RCVTIMEO, timeval{5, 0});
+  CHECK(wait_until([&] { return opened == 1; }), "the first connection not opened");
+  const transport_key_t first_key = key;
+  transport_handle_t first_handle = handle;
+  CHECK(service.write(first_key, std::vector<char>{'h', 'e', 'l', 'l', 'o'}) == 5, "write by valid key failed");
+  CHECK(recv_string(first, 5) == "hello", "the first connection not received data written by key");
+
+  first.close();
+  CHECK(wait_until([&] { return closed == 1; }), "the first connection not closed");
+  CHECK(service.write(first_key, std::vector<char>{'x'}) < 0, "write by stale key accepted");
+  CHECK(service.write(first_key, make_shared_buffer(std::vector<char>{'x'})) < 0, "write shared buffer by stale key accepted");
+  // the handle of closed transport, must not wakeup or close anything
+  service.close(first_handle);
+
+  xxsocket second;
+  second.pconnect("127.0.0.1", SERVER_PORT);
+  second.set_optval(SOL_SOCKET, SO_RCVTIMEO, timeval{5, 0});
+  CHECK(wait_until([&] { return opened == 2; }), "the second connection not opened");
+  const transport_key_t second_key = key;
+  CHECK(static_cast<uint32_t>(second_key) == static_cast<uint32_t>(first_key), "the free slot not reused, keys: %llx, %llx",
+        (unsigned long long)first_key, (unsigned long long)second_key);
+  CHECK(second_key != first_key, "the generation of reused slot not changed");
+
+  // the stale key still rejected after the slot reused
+  CHECK(service.write(first_key, std::vector<char>{'x'}) < 0, "write by stale key accepted after slot reused");
+  CHECK(service.write(second_key, std::vector<char>{'w', 'o', 'r', 'l', 'd'}) == 5, "write by new key failed");
+  CHECK(recv_string(second, 5) == "world", "the second connection received unexpected data");
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  CHECK(closed == 1 && service.is_open(handle.load()), "the second connection closed by stale handle");
+
+  service.stop();
+  printf("transport_key tests: %s, errors=%d\n", errors ? "FAILED" : "PASSED", errors);
+  return errors ? 1 : 0;
+}
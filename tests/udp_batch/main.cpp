@@ -0,0 +1,72 @@
+// The udp server batch receive regression test: two IPv4 peers which address+port sums are equal send datagrams
+// in one recvmmsg batch, each datagram must be dispatched to the transport of its own peer.
+#include <stdio.h>
+#include <thread>
+#include <string>
+
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+static const u_short SERVER_PORT = 18256;
+
+int main(int, char**)
+{
+  // 127.1.0.1 is 0x100 greater than 127.0.0.1 as s_addr on little endian, port + 1 is 0x100 greater as sin_port
+  ip::endpoint ep1("127.0.0.1", 20001), ep2("127.1.0.1", 20000);
+  if (!std::operator==(ep1, ep2) || ip::endpoint_equal_to{}(ep1, ep2))
+  {
+    printf("the sums of endpoints aren't equal on this platform, skipped\n");
+    return 0;
+  }
+
+  int errors = 0, received = 0;
+  io_hostent host("127.0.0.1", SERVER_PORT);
+  io_service service(&host, 1);
+  service.set_option(YOPT_S_DEFERRED_EVENT, 0);
+  service.set_option(YOPT_S_UDP_BATCH_SIZE, 8, 8);
+  // the peer transport socket is bound to the server address
+  service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+  service.start([&](event_ptr&& ev) {
+    if (ev->kind() != YEK_ON_PACKET)
+      return;
+    // the payload is the peer sent it
+    std::string from(packet_data(ev->packet()), packet_len(ev->packet()));
+    auto peer = ev->transport()->remote_endpoint().to_string();
+    if (from != peer)
+    {
+      printf("the datagram from %s dispatched to transport of %s\n", from.c_str(), peer.c_str());
+      ++errors;
+    }
+    ++received;
+  });
+  service.open(0, YCK_UDP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  // block the service thread, so the datagrams of both peers are received in one batch
+  service.schedule(std::chrono::milliseconds(1), [](io_service&) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    return true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  ip::endpoint server_ep("127.0.0.1", SERVER_PORT);
+  xxsocket s1, s2;
+  if (!s1.open(AF_INET, SOCK_DGRAM) || !s2.open(AF_INET, SOCK_DGRAM) || s1.bind(ep1) != 0 || s2.bind(ep2) != 0)
+  {
+    printf("bind peers failed, skipped\n");
+    return 0;
+  }
+  for (auto s : {&s1, &s2})
+  {
+    auto from = s->local_endpoint().to_string();
+    s->sendto(from.c_str(), static_cast<int>(from.size()), server_ep);
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(600));
+  service.stop();
+
+  printf("received=%d errors=%d\n", received, errors);
+  return (received == 2 && errors == 0) ? 0 : 1;
+}
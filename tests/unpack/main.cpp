@@ -0,0 +1,366 @@
+// The frame decode tests: the client sends the bytes in parts with pauses, so the frames span reads or several
+// frames arrive in one read, the packets and events of server must be same as the frames sent.
+#include <stdio.h>
+#include <thread>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "yasio/yasio.hpp"
+#include "yasio/obstream.hpp"
+
+using namespace yasio;
+using namespace yasio::inet;
+
+static u_short server_port = 18260;
+static int errors          = 0;
+
+struct frame_event {
+  int kind;
+  int status;
+  std::string data;
+  bool viewed; // the packet delivered as io_packet_view, see YCF_PACKET_VIEW
+  io_packet_view view;
+};
+
+static std::string to_string(const frame_event& ev)
+{
+  char buf[64];
+  snprintf(buf, sizeof(buf), "{kind=%d, status=%d, size=%d%s}", ev.kind, ev.status, static_cast<int>(ev.data.size()), ev.viewed ? ", viewed" : "");
+  return buf;
+}
+
+// The 4 bytes big endian length field of payload, see length field params of run_length_field
+static std::string length_field_frame(const std::string& payload)
+{
+  auto n = static_cast<uint32_t>(payload.size());
+  std::string frame{static_cast<char>(n >> 24), static_cast<char>(n >> 16), static_cast<char>(n >> 8), static_cast<char>(n)};
+  return frame + payload;
+}
+
+// The 7-bit encoded length of payload, see YUF_VARINT
+static std::string varint_frame(const std::string& payload)
+{
+  obstream obs;
+  obs.write_v(payload);
+  return std::string(obs.data(), obs.length());
+}
+
+// Run the server channel configured by setup, the client sends the parts then close, returns the events until closed
+static std::vector<frame_event> run_case(const std::function<void(io_service&)>& setup, const std::vector<std::string>& parts)
+{
+  std::mutex mtx;
+  std::vector<frame_event> events;
+  std::atomic<bool> closed{false};
+
+  io_hostent host("127.0.0.1", ++server_port);
+  io_service service(&host, 1);
+  service.set_option(YOPT_S_DEFERRED_EVENT, 0);
+  // the server closes first when the frame is invalid, the port may in TIME_WAIT at next run
+  service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+  setup(service);
+  service.start([&](event_ptr&& ev) {
+    switch (ev->kind())
+    {
+      case YEK_ON_PACKET:
+      case YEK_ON_PACKET_BEGIN:
+      case YEK_ON_PACKET_CHUNK:
+      case YEK_ON_PACKET_END:
+      case YEK_ON_CLOSE: {
+        frame_event fe{ev->kind(), ev->status()};
+        // the view refers the recv chunk, hold it until the service stopped to check the chunk isn't reused
+        if (!ev->packet_view().empty())
+        {
+          fe.viewed = true;
+          fe.view   = ev->packet_view();
+        } // the shared packet is null if the event has no payload
+        else if (ev->kind() == YEK_ON_PACKET || ev->kind() == YEK_ON_PACKET_CHUNK)
+          fe.data.assign(packet_data(ev->packet()), packet_len(ev->packet()));
+        std::lock_guard<std::mutex> lck(mtx);
+        events.push_back(std::move(fe));
+        if (ev->kind() == YEK_ON_CLOSE)
+          closed = true;
+        break;
+      }
+    }
+  });
+  service.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  xxsocket client;
+  if (client.pconnect("127.0.0.1", server_port) == 0)
+  {
+    client.set_optval(IPPROTO_TCP, TCP_NODELAY, 1);
+    for (auto& part : parts)
+    { // the pause makes server read each part separately
+      std::this_thread::sleep_for(std::chrono::milliseconds(30));
+      client.send(part.data(), static_cast<int>(part.size()));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    client.close();
+    for (int i = 0; i < 500 && !closed; ++i)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  service.stop();
+  for (auto& ev : events)
+    if (ev.viewed)
+      ev.data.assign(ev.view.data(), ev.view.size());
+  return events;
+}
+
+static void check_events(const char* name, const std::vector<frame_event>& actual, const std::vector<frame_event>& expected)
+{
+  bool ok = actual.size() == expected.size();
+  for (size_t i = 0; ok && i < actual.size(); ++i)
+    ok = actual[i].kind == expected[i].kind && actual[i].status == expected[i].status && actual[i].data == expected[i].data &&
+         actual[i].viewed == expected[i].viewed;
+  if (!ok)
+  {
+    ++errors;
+    printf("%s: FAILED\n  expected:", name);
+    for (auto& ev : expected)
+      printf(" %s", to_string(ev).c_str());
+    printf("\n  actual:  ");
+    for (auto& ev : actual)
+      printf(" %s", to_string(ev).c_str());
+    printf("\n");
+  }
+  else
+    printf("%s: PASSED\n", name);
+}
+
+// Merge the consecutive chunks of streaming frame, the chunk sizes depend on reads, but the offsets must be contiguous
+static std::vector<frame_event> merge_chunks(const char* name, const std::vector<frame_event>& events)
+{
+  std::vector<frame_event> merged;
+  for (auto& ev : events)
+  {
+    if (ev.kind == YEK_ON_PACKET_CHUNK && !merged.empty() && merged.back().kind == YEK_ON_PACKET_CHUNK)
+    {
+      auto& chunk = merged.back();
+      if (ev.status != chunk.status + static_cast<int>(chunk.data.size()))
+      {
+        ++errors;
+        printf("%s: the chunk offset %d isn't contiguous, expected %d\n", name, ev.status, chunk.status + static_cast<int>(chunk.data.size()));
+      }
+      chunk.data += ev.data;
+    }
+    else
+      merged.push_back(ev);
+  }
+  return merged;
+}
+
+static frame_event packet(const std::string& data) { return frame_event{YEK_ON_PACKET, 0, data}; }
+static frame_event view_packet(const std::string& data) { return frame_event{YEK_ON_PACKET, 0, data, true}; }
+static frame_event close_event() { return frame_event{YEK_ON_CLOSE, yasio::errc::eof, std::string{}}; }
+
+static void test_length_field()
+{
+  // length field: offset 0, 4 bytes, the length is payload size
+  auto setup = [](io_service& service) { service.set_option(YOPT_C_UNPACK_PARAMS, 0, 65536, 0, 4, 4); };
+  auto f1 = length_field_frame("hello"), f2 = length_field_frame(std::string(300, 'a')), f3 = length_field_frame("x"), f4 = length_field_frame("");
+
+  // multi frames in one read, the empty payload frame is 4 bytes header only
+  check_events("length_field: multi frames per read", run_case(setup, {f1 + f2 + f3}), {packet(f1), packet(f2), packet(f3), close_event()});
+
+  // the frames span reads, the header itself is split too
+  check_events("length_field: frames span reads",
+               run_case(setup, {f1 + f2.substr(0, 2), f2.substr(2, 100), f2.substr(102) + f3 + f4.substr(0, 3), f4.substr(3) + f1}),
+               {packet(f1), packet(f2), packet(f3), packet(f4), packet(f1), close_event()});
+
+  // strip the length field
+  auto strip = [&](io_service& service) {
+    setup(service);
+    service.set_option(YOPT_C_UNPACK_STRIP, 0, 4);
+  };
+  check_events("length_field: strip header", run_case(strip, {f1 + f2.substr(0, 150), f2.substr(150) + f3}),
+               {packet("hello"), packet(std::string(300, 'a')), packet("x"), close_event()});
+}
+
+static void test_varint()
+{
+  auto setup = [](io_service& service) { service.set_option(YOPT_C_UNPACK_FRAMER, 0, YUF_VARINT); };
+  // the length field is 1, 2 and 3 bytes
+  auto f1 = varint_frame("hello"), f2 = varint_frame(std::string(200, 'b')), f3 = varint_frame(std::string(20000, 'c'));
+  if (f1.size() != 1 + 5 || f2.size() != 2 + 200 || f3.size() != 3 + 20000)
+  {
+    ++errors;
+    printf("varint: the frames not encoded as expected\n");
+    return;
+  }
+  check_events("varint: multi frames per read", run_case(setup, {f1 + f2 + f1}), {packet(f1), packet(f2), packet(f1), close_event()});
+  // split inside the length field, and inside the payload
+  auto events = run_case(setup, {f1 + f3.substr(0, 1), f3.substr(1, 1), f3.substr(2, 9000), f3.substr(9002) + f2.substr(0, 1), f2.substr(1)});
+  check_events("varint: frames span reads", events, {packet(f1), packet(f3), packet(f2), close_event()});
+}
+
+static void test_delimiter()
+{
+  auto lf = [](io_service& service) { service.set_option(YOPT_C_UNPACK_FRAMER, 0, YUF_DELIMITER); };
+  check_events("delimiter: multi frames per read", run_case(lf, {"line1\nline2\nli", "ne3\n", "\n"}),
+               {packet("line1\n"), packet("line2\n"), packet("line3\n"), packet("\n"), close_event()});
+
+  auto crlf = [](io_service& service) {
+    service.set_option(YOPT_C_UNPACK_FRAMER, 0, YUF_DELIMITER);
+    service.set_option(YOPT_C_UNPACK_DELIMITER, 0, "\r\n");
+  };
+  // the delimiter itself is split, the partial delimiter in frame isn't a delimiter
+  check_events("delimiter: frames span reads", run_case(crlf, {"GET / HTTP/1.1\r", "\nHost: a\rb\r\n", "\r", "\n"}),
+               {packet("GET / HTTP/1.1\r\n"), packet("Host: a\rb\r\n"), packet("\r\n"), close_event()});
+}
+
+static void test_fixed_length_field()
+{
+  // 2 bytes magic, 2 bytes big endian length of payload
+  auto setup = [](io_service& service) {
+    service.set_option(YOPT_C_UNPACK_FRAMER, 0, YUF_DELIMITER); // the decoder takes place of builtin framers
+    service.set_option(YOPT_C_UNPACK_DECODER, 0, &fixed_length_field<2, 2, network_convert_tag, 4>::decode_len);
+  };
+  auto frame = [](const std::string& payload) {
+    auto n = static_cast<uint16_t>(payload.size());
+    return std::string{'\x5a', '\x5a', static_cast<char>(n >> 8), static_cast<char>(n)} + payload;
+  };
+  auto f1 = frame("hello\n"), f2 = frame(std::string(1000, 'd')), f3 = frame("");
+  check_events("fixed_length_field: multi frames per read", run_case(setup, {f1 + f2 + f3 + f1}),
+               {packet(f1), packet(f2), packet(f3), packet(f1), close_event()});
+  auto events = run_case(setup, {f1.substr(0, 1), f1.substr(1, 2), f1.substr(3) + f2.substr(0, 500), f2.substr(500) + f3});
+  check_events("fixed_length_field: frames span reads", events, {packet(f1), packet(f2), packet(f3), close_event()});
+
+  // 4 bytes host order length, the frame exceeds max frame length is invalid
+  auto host_order = [](io_service& service) {
+    service.set_option(YOPT_C_UNPACK_DECODER, 0, &fixed_length_field<0, 4, host_convert_tag, 4, 64>::decode_len);
+  };
+  auto host_frame = [](const std::string& payload) {
+    auto n = static_cast<uint32_t>(payload.size());
+    return std::string(reinterpret_cast<const char*>(&n), sizeof(n)) + payload;
+  };
+  auto f4 = host_frame("abc"), f5 = host_frame(std::string(61, 'e'));
+  check_events("fixed_length_field: host order and max frame length", run_case(host_order, {f4.substr(0, 2), f4.substr(2) + f5}),
+               {packet(f4), frame_event{YEK_ON_CLOSE, yasio::errc::invalid_packet, std::string{}}});
+}
+
+static void test_stream()
+{
+  // the frames which payload exceeds 100 bytes are streaming, the length field is stripped
+  auto setup = [](io_service& service) {
+    service.set_option(YOPT_C_UNPACK_PARAMS, 0, 65536, 0, 4, 4);
+    service.set_option(YOPT_C_UNPACK_STRIP, 0, 4);
+    service.set_option(YOPT_C_UNPACK_STREAM, 0, 100);
+  };
+  std::string payload;
+  for (int i = 0; i < 30000; ++i)
+    payload.push_back(static_cast<char>(i % 251));
+  auto f1 = length_field_frame(payload), f2 = length_field_frame("small"), f3 = length_field_frame(std::string(101, 'f'));
+  auto begin = [](int size) { return frame_event{YEK_ON_PACKET_BEGIN, size, std::string{}}; };
+  auto chunk = [](const std::string& data) { return frame_event{YEK_ON_PACKET_CHUNK, 0, data}; };
+  auto end   = [](int size) { return frame_event{YEK_ON_PACKET_END, size, std::string{}}; };
+
+  // the header split, the buffered frame follows the streaming frame in same read
+  const char* name = "stream: chunks and buffered frames";
+  auto events      = run_case(setup, {f1.substr(0, 2), f1.substr(2, 10000), f1.substr(10002) + f2 + f3});
+  check_events(name, merge_chunks(name, events),
+               {begin(30000), chunk(payload), end(30000), packet("small"), begin(101), chunk(std::string(101, 'f')), end(101), close_event()});
+
+  // the streaming frames back to back in one read
+  name   = "stream: multi frames per read";
+  events = run_case(setup, {f3 + f3 + f2});
+  check_events(name, merge_chunks(name, events),
+               {begin(101), chunk(std::string(101, 'f')), end(101), begin(101), chunk(std::string(101, 'f')), end(101), packet("small"), close_event()});
+
+  // the peer closed in the middle of frame, no YEK_ON_PACKET_END
+  name   = "stream: closed in the middle of frame";
+  events = run_case(setup, {f1.substr(0, 3000), f1.substr(3000, 2004)});
+  check_events(name, merge_chunks(name, events), {begin(30000), chunk(payload.substr(0, 5000)), close_event()});
+}
+
+static void test_packet_view()
+{
+  auto setup = [](io_service& service) {
+    service.set_option(YOPT_C_UNPACK_PARAMS, 0, 4 * 1024 * 1024, 0, 4, 4);
+    service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_PACKET_VIEW, 0);
+  };
+  // the distinct bytes of each frame, the overwritten chunk referred by view can be detected
+  auto payload = [](size_t size, int seed) {
+    std::string data(size, '\0');
+    for (size_t i = 0; i < size; ++i)
+      data[i] = static_cast<char>((i + seed) % 253);
+    return data;
+  };
+  auto f1 = length_field_frame("hello"), f2 = length_field_frame(std::string(300, 'a')), f3 = length_field_frame("x");
+  check_events("packet_view: multi frames per read", run_case(setup, {f1 + f2 + f3}),
+               {view_packet(f1), view_packet(f2), view_packet(f3), close_event()});
+  check_events("packet_view: frames span reads", run_case(setup, {f1 + f2.substr(0, 2), f2.substr(2, 100), f2.substr(102) + f3}),
+               {view_packet(f1), view_packet(f2), view_packet(f3), close_event()});
+
+  auto strip = [&](io_service& service) {
+    setup(service);
+    service.set_option(YOPT_C_UNPACK_STRIP, 0, 4);
+  };
+  check_events("packet_view: strip header", run_case(strip, {f1 + f2.substr(0, 150), f2.substr(150) + f3}),
+               {view_packet("hello"), view_packet(std::string(300, 'a')), view_packet("x"), close_event()});
+
+  // the frames span the chunk end are copied to next chunk, the frame larger than chunk has its own chunk,
+  // the frame exceeds YASIO_MAX_PDU_BUFFER_SIZE is delivered as packet
+  std::string stream;
+  std::vector<frame_event> expected;
+  for (int i = 0; i < 5; ++i)
+  {
+    auto frame = length_field_frame(payload(40000, i));
+    stream += frame;
+    expected.push_back(view_packet(frame));
+  }
+  auto large = length_field_frame(payload(200000, 5)), oversized = length_field_frame(payload(YASIO_MAX_PDU_BUFFER_SIZE, 6));
+  stream += large + oversized + f1;
+  expected.push_back(view_packet(large));
+  expected.push_back(packet(oversized));
+  expected.push_back(view_packet(f1));
+  expected.push_back(close_event());
+  std::vector<std::string> parts;
+  for (size_t offset = 0; offset < stream.size(); offset += 30000)
+    parts.push_back(stream.substr(offset, 30000));
+  check_events("packet_view: frames span chunks", run_case(setup, parts), expected);
+}
+
+static void test_read_budget()
+{
+  // the budget 0 reads once per transport per loop, the remain bytes and the close of peer are pending in kernel
+  auto setup = [](io_service& service) {
+    service.set_option(YOPT_C_UNPACK_PARAMS, 0, 65536, 0, 4, 4);
+    service.set_option(YOPT_S_READ_BUDGET, 0);
+  };
+  std::string stream;
+  std::vector<frame_event> expected, viewed;
+  for (int i = 0; i < 3000; ++i)
+  {
+    std::string payload(1000 + i % 7, '\0');
+    for (size_t k = 0; k < payload.size(); ++k)
+      payload[k] = static_cast<char>(i + k);
+    auto frame = length_field_frame(payload);
+    stream += frame;
+    expected.push_back(packet(frame));
+    viewed.push_back(view_packet(frame));
+  }
+  expected.push_back(close_event());
+  viewed.push_back(close_event());
+  check_events("read_budget: burst exceeds buffer", run_case(setup, {stream}), expected);
+
+  auto view = [&](io_service& service) {
+    setup(service);
+    service.set_option(YOPT_C_MOD_FLAGS, 0, YCF_PACKET_VIEW, 0);
+  };
+  check_events("read_budget: burst exceeds chunk", run_case(view, {stream}), viewed);
+}
+
+int main(int, char**)
+{
+  test_length_field();
+  test_varint();
+  test_delimiter();
+  test_fixed_length_field();
+  test_stream();
+  test_packet_view();
+  test_read_budget();
+  printf("unpack tests: %s, errors=%d\n", errors ? "FAILED" : "PASSED", errors);
+  return errors ? 1 : 0;
+}
@@ -180,6 +180,7 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
         {
           case YOPT_C_LOCAL_HOST:
           case YOPT_C_REMOTE_HOST:
+          case YOPT_C_UNPACK_DELIMITER:
             service->set_option(opt, static_cast<int>(args[0]), args[1].as<const char*>());
             break;
 #  if YASIO_VERSION_NUM >= 0x033100
@@ -188,6 +189,10 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
           case YOPT_C_LOCAL_PORT:
           case YOPT_C_REMOTE_PORT:
           case YOPT_C_KCP_CONV:
+          case YOPT_C_LISTEN_BACKLOG:
+          case YOPT_C_UNPACK_FRAMER:
+          case YOPT_C_UNPACK_STREAM:
+          case YOPT_S_UDP_BATCH_SIZE:
             service->set_option(opt, static_cast<int>(args[0]), static_cast<int>(args[1]));
             break;
           case YOPT_C_ENABLE_MCAST:
@@ -196,6 +201,8 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
             service->set_option(opt, static_cast<int>(args[0]), args[1].as<const char*>(), static_cast<int>(args[2]));
             break;
           case YOPT_C_MOD_FLAGS:
+          case YOPT_C_WRITE_WATERMARKS:
+          case YOPT_C_WRITE_LIMIT:
             service->set_option(opt, static_cast<int>(args[0]), static_cast<int>(args[1]), static_cast<int>(args[2]));
             break;
           case YOPT_S_TCP_KEEPALIVE:
@@ -236,7 +243,16 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
           [](io_service* service, transport_handle_t transport, yasio::obstream* obs, cxx17::string_view ip, u_short port) {
             return service->write_to(transport, std::move(obs->buffer()), ip::endpoint{ip.data(), port});
           }),
-      "native_ptr", [](io_service* service) { return (void*)service; });
+      "broadcast",
+      sol::overload(
+          [](io_service* service, int cindex, cxx17::string_view s) {
+            return service->broadcast(cindex, make_shared_buffer(std::vector<char>(s.data(), s.data() + s.length())));
+          },
+          [](io_service* service, int cindex, yasio::obstream* obs) { return service->broadcast(cindex, make_shared_buffer(std::move(obs->buffer()))); }),
+      "add_channel",
+      sol::overload([](io_service* service) { return service->add_channel(); },
+                    [](io_service* service, cxx17::string_view host, u_short port) { return service->add_channel(io_hostent{host, port}); }),
+      "remove_channel", &io_service::remove_channel, "native_ptr", [](io_service* service) { return (void*)service; });
 
   // ##-- obstream
   lyasio::register_obstream<obstream>(yasio_lib, "obstream");
@@ -281,6 +297,10 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
   YASIO_EXPORT_ENUM(YOPT_S_DNS_CACHE_TIMEOUT);
   YASIO_EXPORT_ENUM(YOPT_S_DNS_QUERIES_TIMEOUT);
   YASIO_EXPORT_ENUM(YOPT_S_TCP_KEEPALIVE);
+  YASIO_EXPORT_ENUM(YOPT_S_UDP_BATCH_SIZE);
+  YASIO_EXPORT_ENUM(YOPT_S_ZEROCOPY_THRESHOLD);
+  YASIO_EXPORT_ENUM(YOPT_S_ACCEPT_BUDGET);
+  YASIO_EXPORT_ENUM(YOPT_S_READ_BUDGET);
   YASIO_EXPORT_ENUM(YOPT_S_EVENT_CB);
   YASIO_EXPORT_ENUM(YOPT_C_LFBFD_PARAMS);
   YASIO_EXPORT_ENUM(YOPT_C_LOCAL_HOST);
@@ -292,14 +312,34 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
   YASIO_EXPORT_ENUM(YOPT_C_ENABLE_MCAST);
   YASIO_EXPORT_ENUM(YOPT_C_DISABLE_MCAST);
   YASIO_EXPORT_ENUM(YOPT_C_KCP_CONV);
+  YASIO_EXPORT_ENUM(YOPT_C_LISTEN_BACKLOG);
+  YASIO_EXPORT_ENUM(YOPT_C_WRITE_WATERMARKS);
+  YASIO_EXPORT_ENUM(YOPT_C_WRITE_LIMIT);
+  YASIO_EXPORT_ENUM(YOPT_C_UNPACK_FRAMER);
+  YASIO_EXPORT_ENUM(YOPT_C_UNPACK_DELIMITER);
+  YASIO_EXPORT_ENUM(YOPT_C_UNPACK_STREAM);
   YASIO_EXPORT_ENUM(YOPT_C_MOD_FLAGS);
 
   YASIO_EXPORT_ENUM(YCF_REUSEADDR);
   YASIO_EXPORT_ENUM(YCF_EXCLUSIVEADDRUSE);
+  YASIO_EXPORT_ENUM(YCF_UDP_GSO);
+  YASIO_EXPORT_ENUM(YCF_UDP_SHARED_SOCKET);
+
+  YASIO_EXPORT_ENUM(YWLP_REJECT);
+  YASIO_EXPORT_ENUM(YWLP_CLOSE);
+
+  YASIO_EXPORT_ENUM(YUF_LENGTH_FIELD);
+  YASIO_EXPORT_ENUM(YUF_VARINT);
+  YASIO_EXPORT_ENUM(YUF_DELIMITER);
 
   YASIO_EXPORT_ENUM(YEK_ON_OPEN);
   YASIO_EXPORT_ENUM(YEK_ON_CLOSE);
   YASIO_EXPORT_ENUM(YEK_ON_PACKET);
+  YASIO_EXPORT_ENUM(YEK_ON_WRITE_BLOCKED);
+  YASIO_EXPORT_ENUM(YEK_ON_WRITE_DRAINED);
+  YASIO_EXPORT_ENUM(YEK_ON_PACKET_BEGIN);
+  YASIO_EXPORT_ENUM(YEK_ON_PACKET_CHUNK);
+  YASIO_EXPORT_ENUM(YEK_ON_PACKET_END);
   YASIO_EXPORT_ENUM(YEK_CONNECT_RESPONSE);
   YASIO_EXPORT_ENUM(YEK_CONNECTION_LOST);
   YASIO_EXPORT_ENUM(YEK_PACKET);
@@ -555,12 +595,23 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
               [](io_service* service, transport_handle_t transport, yasio::obstream* obs, cxx17::string_view ip, u_short port) {
                 return service->write_to(transport, std::move(obs->buffer()), ip::endpoint{ip.data(), port});
               })
+          .addOverloadedFunctions(
+              "broadcast",
+              [](io_service* service, int cindex, cxx17::string_view s) {
+                return service->broadcast(cindex, make_shared_buffer(std::vector<char>(s.data(), s.data() + s.length())));
+              },
+              [](io_service* service, int cindex, yasio::obstream* obs) { return service->broadcast(cindex, make_shared_buffer(std::move(obs->buffer()))); })
+          .addOverloadedFunctions(
+              "add_channel", [](io_service* service) { return service->add_channel(); },
+              [](io_service* service, cxx17::string_view host, u_short port) { return service->add_channel(io_hostent{host, port}); })
+          .addFunction("remove_channel", &io_service::remove_channel)
           .addStaticFunction("set_option",
                              [](io_service* service, int opt, kaguya::VariadicArgType args) {
                                switch (opt)
                                {
                                  case YOPT_C_LOCAL_HOST:
                                  case YOPT_C_REMOTE_HOST:
+                                 case YOPT_C_UNPACK_DELIMITER:
                                    service->set_option(opt, static_cast<int>(args[0]), static_cast<const char*>(args[1]));
                                    break;
 
@@ -570,6 +621,10 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
                                  case YOPT_C_LOCAL_PORT:
                                  case YOPT_C_REMOTE_PORT:
                                  case YOPT_C_KCP_CONV:
+                                 case YOPT_C_LISTEN_BACKLOG:
+                                 case YOPT_C_UNPACK_FRAMER:
+                                 case YOPT_C_UNPACK_STREAM:
+                                 case YOPT_S_UDP_BATCH_SIZE:
                                    service->set_option(opt, static_cast<int>(args[0]), static_cast<int>(args[1]));
                                    break;
                                  case YOPT_C_ENABLE_MCAST:
@@ -578,6 +633,8 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
                                    service->set_option(opt, static_cast<int>(args[0]), static_cast<const char*>(args[1]), static_cast<int>(args[2]));
                                    break;
                                  case YOPT_C_MOD_FLAGS:
+                                 case YOPT_C_WRITE_WATERMARKS:
+                                 case YOPT_C_WRITE_LIMIT:
                                    service->set_option(opt, static_cast<int>(args[0]), static_cast<int>(args[1]), static_cast<int>(args[2]));
                                    break;
                                  case YOPT_S_TCP_KEEPALIVE:
@@ -647,6 +704,10 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
   YASIO_EXPORT_ENUM(YOPT_S_DNS_CACHE_TIMEOUT);
   YASIO_EXPORT_ENUM(YOPT_S_DNS_QUERIES_TIMEOUT);
   YASIO_EXPORT_ENUM(YOPT_S_TCP_KEEPALIVE);
+  YASIO_EXPORT_ENUM(YOPT_S_UDP_BATCH_SIZE);
+  YASIO_EXPORT_ENUM(YOPT_S_ZEROCOPY_THRESHOLD);
+  YASIO_EXPORT_ENUM(YOPT_S_ACCEPT_BUDGET);
+  YASIO_EXPORT_ENUM(YOPT_S_READ_BUDGET);
   YASIO_EXPORT_ENUM(YOPT_S_EVENT_CB);
   YASIO_EXPORT_ENUM(YOPT_C_LFBFD_PARAMS);
   YASIO_EXPORT_ENUM(YOPT_C_LOCAL_HOST);
@@ -658,14 +719,34 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
   YASIO_EXPORT_ENUM(YOPT_C_ENABLE_MCAST);
   YASIO_EXPORT_ENUM(YOPT_C_DISABLE_MCAST);
   YASIO_EXPORT_ENUM(YOPT_C_KCP_CONV);
+  YASIO_EXPORT_ENUM(YOPT_C_LISTEN_BACKLOG);
+  YASIO_EXPORT_ENUM(YOPT_C_WRITE_WATERMARKS);
+  YASIO_EXPORT_ENUM(YOPT_C_WRITE_LIMIT);
+  YASIO_EXPORT_ENUM(YOPT_C_UNPACK_FRAMER);
+  YASIO_EXPORT_ENUM(YOPT_C_UNPACK_DELIMITER);
+  YASIO_EXPORT_ENUM(YOPT_C_UNPACK_STREAM);
   YASIO_EXPORT_ENUM(YOPT_C_MOD_FLAGS);
 
   YASIO_EXPORT_ENUM(YCF_REUSEADDR);
   YASIO_EXPORT_ENUM(YCF_EXCLUSIVEADDRUSE);
+  YASIO_EXPORT_ENUM(YCF_UDP_GSO);
+  YASIO_EXPORT_ENUM(YCF_UDP_SHARED_SOCKET);
+
+  YASIO_EXPORT_ENUM(YWLP_REJECT);
+  YASIO_EXPORT_ENUM(YWLP_CLOSE);
+
+  YASIO_EXPORT_ENUM(YUF_LENGTH_FIELD);
+  YASIO_EXPORT_ENUM(YUF_VARINT);
+  YASIO_EXPORT_ENUM(YUF_DELIMITER);
 
   YASIO_EXPORT_ENUM(YEK_ON_OPEN);
   YASIO_EXPORT_ENUM(YEK_ON_CLOSE);
   YASIO_EXPORT_ENUM(YEK_ON_PACKET);
+  YASIO_EXPORT_ENUM(YEK_ON_WRITE_BLOCKED);
+  YASIO_EXPORT_ENUM(YEK_ON_WRITE_DRAINED);
+  YASIO_EXPORT_ENUM(YEK_ON_PACKET_BEGIN);
+  YASIO_EXPORT_ENUM(YEK_ON_PACKET_CHUNK);
+  YASIO_EXPORT_ENUM(YEK_ON_PACKET_END);
   YASIO_EXPORT_ENUM(YEK_CONNECT_RESPONSE);
   YASIO_EXPORT_ENUM(YEK_CONNECTION_LOST);
   YASIO_EXPORT_ENUM(YEK_PACKET);
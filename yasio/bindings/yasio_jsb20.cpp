@@ -1300,6 +1300,7 @@ bool js_yasio_io_service_set_option(se::State& s)
       switch (opt)
       {
         case YOPT_C_REMOTE_HOST:
+        case YOPT_C_UNPACK_DELIMITER:
         case YOPT_C_LOCAL_HOST:
           service->set_option(opt, args[1].toInt32(), args[2].toString().c_str());
           break;
@@ -1309,6 +1310,10 @@ bool js_yasio_io_service_set_option(se::State& s)
         case YOPT_C_LOCAL_PORT:
         case YOPT_C_REMOTE_PORT:
         case YOPT_C_KCP_CONV:
+        case YOPT_C_LISTEN_BACKLOG:
+        case YOPT_C_UNPACK_FRAMER:
+        case YOPT_C_UNPACK_STREAM:
+        case YOPT_S_UDP_BATCH_SIZE:
           service->set_option(opt, args[1].toInt32(), args[2].toInt32());
           break;
         case YOPT_C_ENABLE_MCAST:
@@ -1318,6 +1323,8 @@ bool js_yasio_io_service_set_option(se::State& s)
                               args[3].toInt32());
           break;
         case YOPT_C_MOD_FLAGS:
+        case YOPT_C_WRITE_WATERMARKS:
+        case YOPT_C_WRITE_LIMIT:
           service->set_option(opt, args[1].toInt32(), args[2].toInt32(),
                               args[3].toInt32());
           break;
@@ -1517,6 +1524,10 @@ bool jsb_register_yasio(se::Object* obj)
   YASIO_EXPORT_ENUM(YOPT_S_DNS_CACHE_TIMEOUT);
   YASIO_EXPORT_ENUM(YOPT_S_DNS_QUERIES_TIMEOUT);
   YASIO_EXPORT_ENUM(YOPT_S_TCP_KEEPALIVE);
+  YASIO_EXPORT_ENUM(YOPT_S_UDP_BATCH_SIZE);
+  YASIO_EXPORT_ENUM(YOPT_S_ZEROCOPY_THRESHOLD);
+  YASIO_EXPORT_ENUM(YOPT_S_ACCEPT_BUDGET);
+  YASIO_EXPORT_ENUM(YOPT_S_READ_BUDGET);
   YASIO_EXPORT_ENUM(YOPT_S_EVENT_CB);
   YASIO_EXPORT_ENUM(YOPT_C_LFBFD_PARAMS);
   YASIO_EXPORT_ENUM(YOPT_C_LOCAL_HOST);
@@ -1528,14 +1539,34 @@ bool jsb_register_yasio(se::Object* obj)
   YASIO_EXPORT_ENUM(YOPT_C_ENABLE_MCAST);
   YASIO_EXPORT_ENUM(YOPT_C_DISABLE_MCAST);
   YASIO_EXPORT_ENUM(YOPT_C_KCP_CONV);
+  YASIO_EXPORT_ENUM(YOPT_C_LISTEN_BACKLOG);
+  YASIO_EXPORT_ENUM(YOPT_C_WRITE_WATERMARKS);
+  YASIO_EXPORT_ENUM(YOPT_C_WRITE_LIMIT);
+  YASIO_EXPORT_ENUM(YOPT_C_UNPACK_FRAMER);
+  YASIO_EXPORT_ENUM(YOPT_C_UNPACK_DELIMITER);
+  YASIO_EXPORT_ENUM(YOPT_C_UNPACK_STREAM);
   YASIO_EXPORT_ENUM(YOPT_C_MOD_FLAGS);
 
   YASIO_EXPORT_ENUM(YCF_REUSEADDR);
   YASIO_EXPORT_ENUM(YCF_EXCLUSIVEADDRUSE);
+  YASIO_EXPORT_ENUM(YCF_UDP_GSO);
+  YASIO_EXPORT_ENUM(YCF_UDP_SHARED_SOCKET);
+
+  YASIO_EXPORT_ENUM(YWLP_REJECT);
+  YASIO_EXPORT_ENUM(YWLP_CLOSE);
+
+  YASIO_EXPORT_ENUM(YUF_LENGTH_FIELD);
+  YASIO_EXPORT_ENUM(YUF_VARINT);
+  YASIO_EXPORT_ENUM(YUF_DELIMITER);
 
   YASIO_EXPORT_ENUM(YEK_CONNECT_RESPONSE);
   YASIO_EXPORT_ENUM(YEK_CONNECTION_LOST);
   YASIO_EXPORT_ENUM(YEK_PACKET);
+  YASIO_EXPORT_ENUM(YEK_ON_WRITE_BLOCKED);
+  YASIO_EXPORT_ENUM(YEK_ON_WRITE_DRAINED);
+  YASIO_EXPORT_ENUM(YEK_ON_PACKET_BEGIN);
+  YASIO_EXPORT_ENUM(YEK_ON_PACKET_CHUNK);
+  YASIO_EXPORT_ENUM(YEK_ON_PACKET_END);
 
   YASIO_EXPORT_ENUM(YEK_ON_OPEN);
   YASIO_EXPORT_ENUM(YEK_ON_CLOSE);
@@ -144,6 +144,9 @@ YASIO_NI_API void yasio_set_option(void* service_ptr, int opt, const char* pszAr
     case YOPT_S_DNS_CACHE_TIMEOUT:
     case YOPT_S_DNS_QUERIES_TIMEOUT:
     case YOPT_S_DNS_DIRTY:
+    case YOPT_S_ZEROCOPY_THRESHOLD:
+    case YOPT_S_ACCEPT_BUDGET:
+    case YOPT_S_READ_BUDGET:
       service->set_option(opt, atoi(pszArgs));
       return;
   }
@@ -161,6 +164,7 @@ YASIO_NI_API void yasio_set_option(void* service_ptr, int opt, const char* pszAr
   switch (opt)
   {
     case YOPT_C_REMOTE_HOST:
+    case YOPT_C_UNPACK_DELIMITER:
     case YOPT_C_LOCAL_HOST:
       service->set_option(opt, svtoi(args[0]), svtoa(args[1]));
       break;
@@ -168,6 +172,10 @@ YASIO_NI_API void yasio_set_option(void* service_ptr, int opt, const char* pszAr
     case YOPT_C_LOCAL_PORT:
     case YOPT_C_REMOTE_PORT:
     case YOPT_C_KCP_CONV:
+    case YOPT_C_LISTEN_BACKLOG:
+    case YOPT_C_UNPACK_FRAMER:
+    case YOPT_C_UNPACK_STREAM:
+    case YOPT_S_UDP_BATCH_SIZE:
       service->set_option(opt, svtoi(args[0]), svtoi(args[1]));
       break;
     case YOPT_C_ENABLE_MCAST:
@@ -176,6 +184,8 @@ YASIO_NI_API void yasio_set_option(void* service_ptr, int opt, const char* pszAr
       service->set_option(opt, svtoi(args[0]), svtoa(args[1]), svtoi(args[2]));
       break;
     case YOPT_C_MOD_FLAGS:
+    case YOPT_C_WRITE_WATERMARKS:
+    case YOPT_C_WRITE_LIMIT:
       service->set_option(opt, svtoi(args[0]), svtoi(args[1]), svtoi(args[2]));
       break;
     case YOPT_S_TCP_KEEPALIVE:
@@ -226,6 +236,27 @@ YASIO_NI_API int yasio_write_ob(void* service_ptr, void* thandle, void* obs_ptr)
   }
   return -1;
 }
+YASIO_NI_API int yasio_broadcast(void* service_ptr, int cindex, const unsigned char* bytes, int len)
+{
+  auto service = reinterpret_cast<io_service*>(service_ptr);
+  if (service)
+    return service->broadcast(cindex, make_shared_buffer(std::vector<char>(bytes, bytes + len)));
+  return -1;
+}
+YASIO_NI_API int yasio_add_channel(void* service_ptr, const char* host, int port)
+{
+  auto service = reinterpret_cast<io_service*>(service_ptr);
+  if (service)
+    return host ? service->add_channel(io_hostent{host, static_cast<u_short>(port)}) : service->add_channel();
+  return -1;
+}
+YASIO_NI_API int yasio_remove_channel(void* service_ptr, int index)
+{
+  auto service = reinterpret_cast<io_service*>(service_ptr);
+  if (service)
+    return service->remove_channel(index);
+  return -1;
+}
 YASIO_NI_API unsigned int yasio_tcp_rtt(void* thandle)
 {
   auto p = reinterpret_cast<transport_handle_t>(thandle);
@@ -29,6 +29,8 @@ SOFTWARE.
 #define YASIO__CONCURRENT_QUEUE_HPP
 
 #include "yasio/detail/config.hpp"
+#include <atomic>
+#include <memory>
 #if defined(YASIO_USE_SPSC_QUEUE)
 #  include "moodycamel/readerwriterqueue.h"
 #else
@@ -44,6 +46,129 @@ template <typename _Ty> inline void clear_queue(_Ty& queue)
 }
 namespace privacy
 {
+// The intrusive node of mpsc_queue
+struct mpsc_node
+{
+  std::atomic<mpsc_node*> next_{nullptr};
+};
+
+/*
+** The intrusive lock-free multi-producer single-consumer queue, base on Dmitry Vyukov's
+** node-based MPSC queue algorithm, _Ty must derive from mpsc_node.
+** Remark: emplace can be called at any thread and costs one atomic exchange only, all others
+**         must be called at the consumer thread, the queue owns the nodes until pop/clear.
+*/
+template <typename _Ty> class mpsc_queue
+{
+public:
+  mpsc_queue() : head_(&stub_), tail_(&stub_), front_(nullptr), back_(nullptr) {}
+  mpsc_queue(const mpsc_queue&) = delete;
+  ~mpsc_queue() { clear(); }
+
+  void emplace(std::unique_ptr<_Ty>&& value) { push(value.release()); }
+
+  // peek the front item without remove it
+  _Ty* peek()
+  {
+    if (front_ == nullptr)
+      front_ = back_ = fetch();
+    return static_cast<_Ty*>(front_);
+  }
+
+  // peek the item after the peeked item, used to traverse the queue without remove items
+  _Ty* next(_Ty* item)
+  {
+    auto next = item->next_.load(std::memory_order_relaxed);
+    if (next == nullptr && item == back_)
+    {
+      next = fetch();
+      if (next != nullptr)
+      {
+        back_->next_.store(next, std::memory_order_relaxed);
+        back_ = next;
+      }
+    }
+    return static_cast<_Ty*>(next);
+  }
+
+  // remove the front item and transfer the ownership to caller
+  std::unique_ptr<_Ty> take()
+  {
+    auto front = peek();
+    if (front)
+    {
+      front_ = front->next_.load(std::memory_order_relaxed);
+      if (front_ == nullptr)
+        back_ = nullptr;
+    }
+    return std::unique_ptr<_Ty>(front);
+  }
+
+  // remove and delete the front item
+  void pop() { take(); }
+
+  // An item which is in the middle of emplace may not be seen, the producer should notify the
+  // consumer after emplace returns.
+  bool empty() const { return front_ == nullptr && tail_ == &stub_ && stub_.next_.load(std::memory_order_acquire) == nullptr; }
+
+  void clear()
+  {
+    while (peek())
+      pop();
+  }
+
+private:
+  // dequeue a node and reset its next_ for the consumer side list
+  mpsc_node* fetch()
+  {
+    auto node = dequeue();
+    if (node != nullptr)
+      node->next_.store(nullptr, std::memory_order_relaxed);
+    return node;
+  }
+
+  void push(mpsc_node* node)
+  {
+    node->next_.store(nullptr, std::memory_order_relaxed);
+    auto prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next_.store(node, std::memory_order_release);
+  }
+
+  mpsc_node* dequeue()
+  {
+    auto tail = tail_;
+    auto next = tail->next_.load(std::memory_order_acquire);
+    if (tail == &stub_)
+    {
+      if (next == nullptr)
+        return nullptr;
+      tail_ = tail = next;
+      next         = next->next_.load(std::memory_order_acquire);
+    }
+    if (next != nullptr)
+    {
+      tail_ = next;
+      return tail;
+    }
+    if (tail != head_.load(std::memory_order_acquire))
+      return nullptr; // a producer is linking the next node, retry later
+    push(&stub_);
+    next = tail->next_.load(std::memory_order_acquire);
+    if (next != nullptr)
+    {
+      tail_ = next;
+      return tail;
+    }
+    return nullptr;
+  }
+
+  std::atomic<mpsc_node*> head_; // producers side
+  mpsc_node* tail_;              // consumer side
+  mpsc_node* front_;             // the consumer side list of dequeued items which not pop yet
+  mpsc_node* back_;
+  mpsc_node stub_;
+};
+
 template <typename _Ty, bool _Dual = false> class concurrent_queue;
 
 #if defined(YASIO_USE_SPSC_QUEUE)
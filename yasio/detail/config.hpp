@@ -41,10 +41,11 @@ SOFTWARE.
 // #define YASIO_VERBOSE_LOG 1
 
 /*
-** Uncomment or add compiler flag -DYASIO_USE_SPSC_QUEUE to use SPSC queue in io_service
+** Uncomment or add compiler flag -DYASIO_USE_SPSC_QUEUE to use SPSC queue for io_service events
 ** Remark: By default, yasio use std's queue + mutex to ensure thread safe, If you want
-**         more fast messege queue and only have one thread to call io_service write APIs,
-**         you may need uncomment it.
+**         more fast event queue and only have one thread to call io_service::dispatch,
+**         you may need uncomment it. The send queue of transport is always a lock-free
+**         MPSC queue, so io_service write APIs can be called at any thread.
 */
 // #define YASIO_USE_SPSC_QUEUE 1
 
@@ -59,6 +60,17 @@ SOFTWARE.
 */
 // #define YASIO_DISABLE_OBJECT_POOL 1
 
+/*
+** Uncomment or add compiler flag -DYASIO_DISABLE_PACKET_POOL to disable recycling of received packet buffers
+*/
+// #define YASIO_DISABLE_PACKET_POOL 1
+
+/*
+** Uncomment or add compiler flag -DYASIO_ENABLE_SHARED_RECV_BUFFER to read into one buffer of io_service
+** instead of the 64K inline buffer of each transport, the transport only keeps the partial frame at heap
+*/
+// #define YASIO_ENABLE_SHARED_RECV_BUFFER 1
+
 /*
 ** Uncomment or add compiler flag -DYASIO_ENABLE_ARES_PROFILER to test async resolve performance
 */
@@ -122,6 +134,19 @@ SOFTWARE.
 */
 // #define YASIO_NO_USER_TIMER 1
 
+/*
+** Uncomment or add compiler flag -DYASIO_DISABLE_EPOLL to use select instead epoll on linux
+*/
+// #define YASIO_DISABLE_EPOLL 1
+
+/*
+** Uncomment or add compiler flag -DYASIO_ENABLE_IO_URING to use io_uring instead epoll on linux
+** remark: requires kernel 5.11+, fallback to epoll at runtime when io_uring not available,
+**   on kernel 6.0+ the tcp transports recv/send and the tcp server accepts are submitted as
+**   io_uring requests (multishot recv & accept) instead of polling readiness
+*/
+// #define YASIO_ENABLE_IO_URING 1
+
 /*
 ** Workaround for 'vs2013 without full c++11 support', in the future, drop vs2013 support and
 ** follow 3 lines code will be removed
@@ -194,6 +219,12 @@ SOFTWARE.
 // The default max listen count of tcp server.
 #define YASIO_SOMAXCONN 19
 
+// The default max tcp connections accepted by a server channel per loop iteration.
+#define YASIO_ACCEPT_BUDGET 64
+
+// The default max bytes read by a tcp transport per loop iteration, see also YOPT_S_READ_BUDGET
+#define YASIO_READ_BUDGET (256 * 1024)
+
 // The max wait duration in microseconds when io_service nothing to do.
 #define YASIO_MAX_WAIT_DURATION (5LL * 60LL * 1000LL * 1000LL)
 
@@ -201,6 +232,16 @@ SOFTWARE.
 // !!!Only affects Single Core CPU
 #define YASIO_MIN_WAIT_DURATION 10LL
 
+// The max bytes of a transport to send in one io_service loop, avoid one transport with huge
+// outgoing data starving others.
+#define YASIO_MAX_SEND_BYTES_PER_LOOP (256 * 1024)
+
+// The max datagrams count of one recvmmsg/sendmmsg call, see also YOPT_S_UDP_BATCH_SIZE
+#define YASIO_MAX_UDP_BATCH 64
+
+// The resolution of timer wheel in microseconds, the timers may fire later up to one resolution.
+#define YASIO_TIMER_WHEEL_RESOLUTION 1000LL
+
 // The default ttl of multicast
 #define YASIO_DEFAULT_MULTICAST_TTL (int)128
 
@@ -210,6 +251,11 @@ SOFTWARE.
 // The max pdu buffer length, avoid large memory allocation when application decode a huge length.
 #define YASIO_MAX_PDU_BUFFER_SIZE static_cast<int>(1 * 1024 * 1024)
 
+// The max free buffers per size class of packet_pool.
+#if !defined(YASIO_PACKET_POOL_CAPACITY)
+#  define YASIO_PACKET_POOL_CAPACITY 64
+#endif
+
 // The max Initial Bytes To Strip for unpack.
 #define YASIO_UNPACK_MAX_STRIP 32
 
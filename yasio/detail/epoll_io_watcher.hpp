@@ -0,0 +1,169 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A multi-platform support c++11 library with focus on asynchronous socket I/O for any
+// client application.
+//////////////////////////////////////////////////////////////////////////////////////////
+/*
+The MIT License (MIT)
+
+Copyright (c) 2012-2021 HALX99
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef YASIO__EPOLL_IO_WATCHER_HPP
+#define YASIO__EPOLL_IO_WATCHER_HPP
+
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+#include "yasio/detail/utils.hpp"
+#include "yasio/xxsocket.hpp"
+
+namespace yasio
+{
+YASIO__NS_INLINE
+namespace inet
+{
+// The linux epoll watcher, level-triggered, keep the same semantics with select_io_watcher
+class epoll_io_watcher {
+public:
+  epoll_io_watcher() : epoll_fd_(::epoll_create1(EPOLL_CLOEXEC)), ready_events_(128) {}
+  ~epoll_io_watcher()
+  {
+    if (epoll_fd_ != -1)
+      ::close(epoll_fd_);
+  }
+
+  void mod_event(socket_native_type fd, int add_events, int remove_events)
+  {
+    auto it         = registered_events_.find(fd);
+    int prev_events = it != registered_events_.end() ? it->second : 0;
+    int events      = (prev_events | add_events) & ~remove_events;
+    if (events == prev_events)
+      return;
+
+    if (events != 0)
+    {
+      epoll_event ev = {to_epoll_events(events), {}};
+      ev.data.fd     = fd;
+      int op         = prev_events != 0 ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+      if (::epoll_ctl(epoll_fd_, op, fd, &ev) != 0)
+      { // the fd may closed & reused without unregister, i.e. the sockets managed by c-ares
+        if (errno == ENOENT)
+          ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+        else if (errno == EEXIST)
+          ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev);
+      }
+      registered_events_[fd] = events;
+    }
+    else
+    {
+      ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+      registered_events_.erase(it);
+    }
+  }
+
+  // @retval: the number of descriptors ready, 0: timeout, < 0: error
+  int poll_io(highp_time_t wait_duration)
+  {
+    // clear ready flags of last poll
+    for (int i = 0; i < nready_; ++i)
+      revents_[ready_events_[i].data.fd] = 0;
+
+    // epoll timeout is milliseconds, round up to avoid busy loop with timeout less than 1ms
+    int timeout = static_cast<int>((std::min)((wait_duration + 999) / 1000, static_cast<highp_time_t>(INT32_MAX)));
+    nready_     = ::epoll_wait(epoll_fd_, ready_events_.data(), static_cast<int>(ready_events_.size()), timeout);
+    if (nready_ <= 0)
+    {
+      int retval = nready_;
+      nready_    = 0;
+      return retval;
+    }
+
+    for (int i = 0; i < nready_; ++i)
+    {
+      auto& ev = ready_events_[i];
+      if (ev.data.fd >= static_cast<int>(revents_.size()))
+        revents_.resize(ev.data.fd + 1);
+      revents_[ev.data.fd] = from_epoll_events(ev.events);
+    }
+
+    int retval = nready_;
+    // all event slots used, enlarge it for next poll
+    if (nready_ == static_cast<int>(ready_events_.size()) && ready_events_.size() < max_ready_events)
+      ready_events_.resize(ready_events_.size() << 1);
+    return retval;
+  }
+
+  int is_ready(socket_native_type fd, int events) const { return fd < static_cast<int>(revents_.size()) ? (revents_[fd] & events) : 0; }
+
+  // traverse the ready descriptors of last poll
+  template <typename _Fty> void for_each_ready(_Fty&& func) const
+  {
+    for (int i = 0; i < nready_; ++i)
+      func(static_cast<socket_native_type>(ready_events_[i].data.fd));
+  }
+
+
+private:
+  enum
+  {
+    max_ready_events = 4096,
+  };
+  static uint32_t to_epoll_events(int events)
+  {
+    uint32_t epoll_events = 0;
+    if (events & YEM_POLLIN)
+      epoll_events |= EPOLLIN;
+    if (events & YEM_POLLOUT)
+      epoll_events |= EPOLLOUT;
+    if (events & YEM_POLLERR)
+      epoll_events |= EPOLLPRI;
+    return epoll_events;
+  }
+  static int from_epoll_events(uint32_t epoll_events)
+  {
+    int events = 0;
+    if (epoll_events & EPOLLIN)
+      events |= YEM_POLLIN;
+    if (epoll_events & EPOLLOUT)
+      events |= YEM_POLLOUT;
+    if (epoll_events & (EPOLLERR | EPOLLHUP))
+      events |= (YEM_POLLIN | YEM_POLLOUT | YEM_POLLERR); // select reports error as readable & writable
+    if (epoll_events & EPOLLPRI)
+      events |= YEM_POLLERR;
+    return events;
+  }
+
+  int epoll_fd_;
+
+  // the registered events of descriptors
+  std::unordered_map<socket_native_type, int> registered_events_;
+
+  // the events of last poll
+  std::vector<epoll_event> ready_events_;
+  int nready_ = 0;
+
+  // the ready flags of descriptors, index by fd
+  std::vector<uint8_t> revents_;
+};
+} // namespace inet
+} // namespace yasio
+
+#endif
@@ -0,0 +1,779 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A multi-platform support c++11 library with focus on asynchronous socket I/O for any
+// client application.
+//////////////////////////////////////////////////////////////////////////////////////////
+/*
+The MIT License (MIT)
+
+Copyright (c) 2012-2021 HALX99
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef YASIO__IO_URING_IO_WATCHER_HPP
+#define YASIO__IO_URING_IO_WATCHER_HPP
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "yasio/detail/epoll_io_watcher.hpp"
+
+// The multishot recv & accept and sync cancel, requires kernel headers 6.0+
+#if defined(IORING_RECV_MULTISHOT)
+#  define YASIO__HAS_IO_URING_COMPLETION 1
+#else
+#  define YASIO__HAS_IO_URING_COMPLETION 0
+#endif
+
+namespace yasio
+{
+YASIO__NS_INLINE
+namespace inet
+{
+// The linux io_uring watcher, requires kernel 5.11+ (IORING_FEAT_EXT_ARG)
+// remark:
+//   a) Keep the same level-triggered semantics with select_io_watcher by one-shot IORING_OP_POLL_ADD,
+//      the fired polls are re-armed at next poll_io, all SQEs of a loop tick are submitted with the
+//      wait by one io_uring_enter syscall.
+//   b) On kernel 6.0+, the stream and listening sockets enabled by enable_stream & enable_acceptor are
+//      served by completions instead of readiness: the multishot recv fills the buffers provided to
+//      kernel by IORING_OP_PROVIDE_BUFFERS, the multishot accept queues the new connections, the send is submitted
+//      as IORING_OP_SENDMSG without copy, one in flight per socket. The completions are routed to the
+//      descriptor (generation checked) and reported as readiness, the transports take them by recv,
+//      sendv and accept instead of syscalls.
+//   c) The requests of completion socket are canceled synchronously when it unregistered, so the
+//      send buffers and the descriptor number can be reused safely after close.
+//   d) Fallback to epoll when io_uring not available, i.e. old kernel or disabled by seccomp.
+class io_uring_io_watcher {
+public:
+  io_uring_io_watcher()
+  {
+    if (!init_ring())
+      fallback_.reset(new epoll_io_watcher());
+  }
+  ~io_uring_io_watcher()
+  {
+    if (ring_fd_ != -1)
+      ::close(ring_fd_);
+    if (sqes_ != MAP_FAILED)
+      ::munmap(sqes_, sqes_size_);
+    if (ring_ptr_ != MAP_FAILED)
+      ::munmap(ring_ptr_, ring_size_);
+    if (bufs_ != MAP_FAILED)
+      ::munmap(bufs_, recv_buf_count * recv_buf_size);
+  }
+
+  void mod_event(socket_native_type fd, int add_events, int remove_events)
+  {
+    if (fallback_)
+      return fallback_->mod_event(fd, add_events, remove_events);
+
+    auto& entry = get_entry(fd);
+    int events  = (entry.events | add_events) & ~remove_events;
+    if (events == 0 && entry.mode != fd_poll)
+    { // the socket will be closed, even the events not changed
+      release_completion(fd, entry);
+      return;
+    }
+    if (events == entry.events)
+      return;
+    int prev_poll_events = entry.poll_events();
+    entry.events         = events;
+    if (entry.poll_events() != prev_poll_events)
+      cancel_poll(entry, fd);
+    pend(fd, entry);
+  }
+
+  // @retval: the number of descriptors ready, 0: timeout, < 0: error
+  int poll_io(highp_time_t wait_duration)
+  {
+    if (fallback_)
+      return fallback_->poll_io(wait_duration);
+
+    // clear ready flags of last poll
+    for (auto fd : ready_fds_)
+      revents_[fd] = 0;
+    ready_fds_.clear();
+
+    // give back the buffers taken, then re-arm the fired polls & multishots and arm the new registered descriptors
+    if (!recycled_bids_.empty())
+      provide_bufs();
+    pending_fds_.swap(arming_fds_);
+    for (auto fd : arming_fds_)
+    {
+      auto& entry   = entries_[fd];
+      entry.pending = false;
+      if (entry.poll_events() && !entry.poll_armed)
+        arm_poll(fd, entry);
+      if (entry.mode != fd_poll && (entry.events & YEM_POLLIN) && !entry.multishot_armed && !entry.closed)
+        arm_multishot(fd, entry);
+    }
+    arming_fds_.clear();
+
+    // don't block when the completed data not taken, i.e. the read budget of transport exhausted
+    if (!rx_fds_.empty())
+      wait_duration = 0;
+    __kernel_timespec ts = {static_cast<int64_t>(wait_duration / 1000000), static_cast<long long>(wait_duration % 1000000) * 1000};
+    io_uring_getevents_arg arg;
+    ::memset(&arg, 0, sizeof(arg));
+    arg.sigmask_sz = _NSIG / 8;
+    arg.ts         = reinterpret_cast<uint64_t>(&ts);
+    int retval     = enter(1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    int error      = errno;
+
+    reap_completions();
+
+    // the completion sockets keep readable until all completed data taken, same as level-triggered
+    for (size_t i = 0; i < rx_fds_.size();)
+    {
+      auto fd     = rx_fds_[i];
+      auto& entry = entries_[fd];
+      if (entry.rx_ready())
+      {
+        set_ready(fd, YEM_POLLIN);
+        ++i;
+      }
+      else
+      {
+        entry.rx_listed = false;
+        rx_fds_[i]      = rx_fds_.back();
+        rx_fds_.pop_back();
+      }
+    }
+
+    if (!ready_fds_.empty())
+      return static_cast<int>(ready_fds_.size());
+    if (retval < 0 && error != ETIME)
+    {
+      errno = error;
+      return -1;
+    }
+    return 0;
+  }
+
+  int is_ready(socket_native_type fd, int events) const
+  {
+    if (fallback_)
+      return fallback_->is_ready(fd, events);
+    return fd < static_cast<int>(revents_.size()) ? (revents_[fd] & events) : 0;
+  }
+
+  // traverse the ready descriptors of last poll
+  template <typename _Fty> void for_each_ready(_Fty&& func) const
+  {
+    if (fallback_)
+      return fallback_->for_each_ready(std::forward<_Fty>(func));
+    for (auto fd : ready_fds_)
+      func(fd);
+  }
+
+  // Serve the connected stream socket by multishot recv and send completion, the readable & writable
+  // are reported when data received or send completed, see recv & sendv
+  // @retval: false: not supported, use the socket primitives
+  bool enable_stream(socket_native_type fd) { return enable_completion(fd, fd_stream); }
+
+  // Serve the listening socket by multishot accept, the readable is reported when connections queued, see accept
+  // @retval: false: not supported, accept by socket
+  bool enable_acceptor(socket_native_type fd) { return enable_completion(fd, fd_acceptor); }
+
+  // Take the received data of stream socket, same as ::recv, returns -1 with EAGAIN when no more data
+  int recv(socket_native_type fd, void* buf, int len)
+  {
+    auto entry = completion_entry(fd, fd_stream);
+    if (!entry)
+      return -1;
+    int n = 0;
+    while (n < len && !entry->rx_bufs.empty())
+    {
+      auto& rx  = entry->rx_bufs.front();
+      int bytes = (std::min)(len - n, rx.size - rx.offset);
+      ::memcpy(static_cast<char*>(buf) + n, bufs_ + rx.bid * recv_buf_size + rx.offset, bytes);
+      n += bytes;
+      rx.offset += bytes;
+      if (rx.offset == rx.size)
+      {
+        recycle_buf(rx.bid);
+        entry->rx_bufs.pop_front();
+      }
+    }
+    if (n > 0 || (entry->closed && entry->error == 0))
+      return n; // 0: the peer closed
+    errno = entry->closed ? entry->error : EAGAIN;
+    return -1;
+  }
+
+  // Send the buffers of stream socket, one send in flight, the buffers must be kept until it completed
+  // @retval: the bytes transferred of last send, -1 with EAGAIN: submitted or still in flight
+  // remark: the caller must pass the same data until the bytes transferred returned
+  int sendv(socket_native_type fd, const iobuf* bufs, int count)
+  {
+    auto entry = completion_entry(fd, fd_stream);
+    if (!entry)
+      return -1;
+    switch (entry->send_state)
+    {
+      case send_inflight:
+        errno = EAGAIN;
+        return -1;
+      case send_completed:
+        entry->send_state = send_idle;
+        if (entry->send_result >= 0)
+          return entry->send_result;
+        errno = -entry->send_result;
+        return -1;
+    }
+    auto sqe = get_sqe();
+    if (!sqe)
+      return xxsocket::sendv(fd, bufs, count, MSG_NOSIGNAL);
+    if (!entry->send)
+      entry->send.reset(new send_req());
+    auto req = entry->send.get();
+    req->iovs.assign(bufs, bufs + count);
+    ::memset(&req->msg, 0, sizeof(req->msg));
+    req->msg.msg_iov    = req->iovs.data();
+    req->msg.msg_iovlen = req->iovs.size();
+    sqe->opcode         = IORING_OP_SENDMSG;
+    sqe->fd             = fd;
+    sqe->addr           = reinterpret_cast<uint64_t>(&req->msg);
+    sqe->len            = 1;
+    sqe->msg_flags      = MSG_NOSIGNAL;
+    sqe->user_data      = make_user_data(fd, op_send, entry->gen);
+    entry->send_state   = send_inflight;
+    errno                 = EAGAIN; // submitted with the wait of next poll_io
+    return -1;
+  }
+
+  // Take the accepted connection of listening socket
+  // @retval: 0: succeed, EAGAIN: no more connections, -1: the socket not enabled by enable_acceptor
+  int accept(socket_native_type fd, socket_native_type& new_sock)
+  {
+    auto entry = completion_entry(fd, fd_acceptor);
+    if (!entry)
+      return -1;
+    if (entry->accepted.empty())
+      return entry->closed ? entry->error : EAGAIN;
+    new_sock = entry->accepted.front();
+    entry->accepted.pop_front();
+    return 0;
+  }
+
+private:
+  enum : unsigned
+  {
+    ring_entries   = 256,
+    cq_entries     = 4096,
+    max_gen        = 0x1fffffff,
+    recv_buf_count = 256, // power of 2
+    recv_buf_size  = 16384,
+    recv_buf_group = 0,
+  };
+  // user_data: the internal flag(1 bit), operation(2 bits), generation(29 bits), fd(32 bits)
+  static const uint64_t internal_user_data = 1ULL << 63;
+  enum : unsigned
+  {
+    op_poll,
+    op_recv,
+    op_send,
+    op_accept,
+  };
+  enum : uint8_t
+  {
+    fd_poll,
+    fd_stream,
+    fd_acceptor,
+  };
+  enum : uint8_t
+  {
+    send_idle,
+    send_inflight,
+    send_completed,
+  };
+
+  struct rx_buf {
+    int bid;
+    int size;
+    int offset;
+  };
+  // the message of send in flight, allocated separately since the entries moved when grow
+  struct send_req {
+    msghdr msg;
+    std::vector<iovec> iovs;
+  };
+  struct fd_entry {
+    int events = 0;
+    // the poll generation changes when poll cancelled, the completion generation changes when socket released
+    unsigned poll_gen = 0;
+    unsigned gen      = 0;
+    uint8_t mode      = fd_poll;
+    bool poll_armed   = false;
+    bool pending      = false;
+
+    // the completion states
+    bool multishot_armed = false;
+    bool closed          = false; // the peer closed or error occurred, no more completions
+    bool rx_listed       = false; // whether in rx_fds_
+    int error            = 0;
+    std::deque<rx_buf> rx_bufs;
+    std::deque<socket_native_type> accepted;
+    uint8_t send_state = send_idle;
+    int send_result    = 0;
+    std::unique_ptr<send_req> send;
+
+    // the events served by poll, the readable & writable of stream are reported by completions
+    int poll_events() const
+    {
+      return mode == fd_poll ? events : events & ~(mode == fd_stream ? (YEM_POLLIN | YEM_POLLOUT) : YEM_POLLIN);
+    }
+    bool rx_ready() const { return !rx_bufs.empty() || !accepted.empty() || closed; }
+  };
+
+  static uint64_t make_user_data(socket_native_type fd, unsigned op, unsigned gen)
+  {
+    return (static_cast<uint64_t>(op) << 61) | (static_cast<uint64_t>(gen & max_gen) << 32) | static_cast<uint32_t>(fd);
+  }
+
+  bool init_ring()
+  {
+    io_uring_params params;
+    ::memset(&params, 0, sizeof(params));
+    params.flags      = IORING_SETUP_CQSIZE;
+    params.cq_entries = cq_entries;
+    ring_fd_          = static_cast<int>(::syscall(__NR_io_uring_setup, ring_entries, &params));
+    if (ring_fd_ == -1)
+      return false;
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_EXT_ARG))
+      return false;
+
+    ring_size_ = (std::max)(params.sq_off.array + params.sq_entries * sizeof(unsigned), params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    ring_ptr_  = ::mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (ring_ptr_ == MAP_FAILED)
+      return false;
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_      = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes_ == MAP_FAILED)
+      return false;
+
+    auto ring      = static_cast<char*>(ring_ptr_);
+    sq_head_       = reinterpret_cast<unsigned*>(ring + params.sq_off.head);
+    sq_tail_       = reinterpret_cast<unsigned*>(ring + params.sq_off.tail);
+    sq_mask_       = *reinterpret_cast<unsigned*>(ring + params.sq_off.ring_mask);
+    sq_size_       = params.sq_entries;
+    cq_head_       = reinterpret_cast<unsigned*>(ring + params.cq_off.head);
+    cq_tail_       = reinterpret_cast<unsigned*>(ring + params.cq_off.tail);
+    cq_mask_       = *reinterpret_cast<unsigned*>(ring + params.cq_off.ring_mask);
+    cqes_          = reinterpret_cast<io_uring_cqe*>(ring + params.cq_off.cqes);
+    sq_tail_local_ = *sq_tail_;
+
+    // the sqe slots are always used in order, so the index array is a identity mapping
+    auto sq_array = reinterpret_cast<unsigned*>(ring + params.sq_off.array);
+    for (unsigned i = 0; i < sq_size_; ++i)
+      sq_array[i] = i;
+
+#if YASIO__HAS_IO_URING_COMPLETION
+    // the completion sockets are released by sync cancel, it's available since kernel 6.0 as multishot recv,
+    // the probe of nonexistent request fails with ENOENT
+    io_uring_sync_cancel_reg reg;
+    ::memset(&reg, 0, sizeof(reg));
+    reg.addr       = internal_user_data;
+    reg.timeout    = {-1, -1};
+    completion_ok_ = ::syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_SYNC_CANCEL, &reg, 1) < 0 && errno == ENOENT;
+#endif
+    return true;
+  }
+
+  fd_entry& get_entry(socket_native_type fd)
+  {
+    if (fd >= static_cast<int>(entries_.size()))
+      entries_.resize(fd + 1);
+    return entries_[fd];
+  }
+
+  fd_entry* completion_entry(socket_native_type fd, uint8_t mode)
+  {
+    if (fd < static_cast<int>(entries_.size()) && entries_[fd].mode == mode)
+      return &entries_[fd];
+    errno = EBADF;
+    return nullptr;
+  }
+
+  bool enable_completion(socket_native_type fd, uint8_t mode)
+  {
+    if (fallback_ || !completion_ok_ || (mode == fd_stream && !init_bufs()))
+      return false;
+    auto& entry = get_entry(fd);
+    if (entry.mode != mode)
+    {
+      int prev_poll_events = entry.poll_events();
+      entry.mode           = mode;
+      if (entry.poll_events() != prev_poll_events)
+        cancel_poll(entry, fd);
+      pend(fd, entry);
+    }
+    return true;
+  }
+
+  // Cancel all requests of the completion socket and wait them completed, the stale completions are
+  // ignored by generation mismatch, the taken buffers are recycled
+  void release_completion(socket_native_type fd, fd_entry& entry)
+  {
+#if YASIO__HAS_IO_URING_COMPLETION
+    if (entry.multishot_armed || entry.poll_armed || entry.send_state == send_inflight)
+    {
+      if (sq_tail_local_ != __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE))
+        enter(0, 0, nullptr, 0); // the send just queued must be submitted before cancel
+      io_uring_sync_cancel_reg reg;
+      ::memset(&reg, 0, sizeof(reg));
+      reg.fd      = fd;
+      reg.flags   = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+      reg.timeout = {-1, -1};
+      ::syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_SYNC_CANCEL, &reg, 1);
+    }
+#endif
+    for (auto& rx : entry.rx_bufs)
+      recycle_buf(rx.bid);
+    for (auto sockfd : entry.accepted)
+      ::close(sockfd);
+
+    fd_entry released;
+    released.poll_gen  = (entry.poll_gen + 1) & max_gen;
+    released.gen       = (entry.gen + 1) & max_gen;
+    released.pending   = entry.pending;
+    released.rx_listed = entry.rx_listed;
+    released.send      = std::move(entry.send); // reuse the allocation, no send in flight after cancel
+    entry              = std::move(released);
+  }
+
+  bool init_bufs()
+  {
+    if (bufs_ == MAP_FAILED)
+    {
+      bufs_ = static_cast<char*>(::mmap(nullptr, recv_buf_count * recv_buf_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+      if (bufs_ == MAP_FAILED)
+        return false;
+      for (int bid = 0; bid < static_cast<int>(recv_buf_count); ++bid)
+        recycle_buf(bid);
+    }
+    return true;
+  }
+
+  // Give back the buffer to kernel at next poll_io
+  void recycle_buf(int bid) { recycled_bids_.push_back(bid); }
+
+  // Provide the recycled buffers to kernel, the consecutive buffers by one request
+  void provide_bufs()
+  {
+#if YASIO__HAS_IO_URING_COMPLETION
+    size_t i = 0;
+    while (i < recycled_bids_.size())
+    {
+      auto sqe = get_sqe();
+      if (!sqe)
+        break; // try again at next poll
+      size_t n = 1;
+      while (i + n < recycled_bids_.size() && recycled_bids_[i + n] == recycled_bids_[i] + static_cast<int>(n))
+        ++n;
+      int bid        = recycled_bids_[i];
+      sqe->opcode    = IORING_OP_PROVIDE_BUFFERS;
+      sqe->fd        = static_cast<int>(n);
+      sqe->addr      = reinterpret_cast<uint64_t>(bufs_ + bid * recv_buf_size);
+      sqe->len       = recv_buf_size;
+      sqe->off       = bid;
+      sqe->buf_group = recv_buf_group;
+      sqe->user_data = internal_user_data;
+      bufs_free_ += static_cast<unsigned>(n);
+      i += n;
+    }
+    recycled_bids_.erase(recycled_bids_.begin(), recycled_bids_.begin() + i);
+#endif
+  }
+
+  io_uring_sqe* get_sqe()
+  {
+    if (sq_tail_local_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_size_)
+    { // the submission queue is full, submit it without wait
+      enter(0, 0, nullptr, 0);
+      if (sq_tail_local_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_size_)
+        return nullptr;
+    }
+    auto sqe = &static_cast<io_uring_sqe*>(sqes_)[sq_tail_local_++ & sq_mask_];
+    ::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+  }
+
+  int enter(unsigned min_complete, unsigned flags, void* arg, size_t argsz)
+  {
+    __atomic_store_n(sq_tail_, sq_tail_local_, __ATOMIC_RELEASE);
+    unsigned to_submit = sq_tail_local_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, arg, argsz));
+  }
+
+  void pend(socket_native_type fd, fd_entry& entry)
+  {
+    if (!entry.pending)
+    {
+      entry.pending = true;
+      pending_fds_.push_back(fd);
+    }
+  }
+
+  void set_ready(socket_native_type fd, int events)
+  {
+    if (fd >= static_cast<int>(revents_.size()))
+      revents_.resize(fd + 1);
+    if (!revents_[fd])
+      ready_fds_.push_back(fd);
+    revents_[fd] |= events;
+  }
+
+  void set_rx_ready(socket_native_type fd, fd_entry& entry)
+  {
+    if (!entry.rx_listed)
+    {
+      entry.rx_listed = true;
+      rx_fds_.push_back(fd);
+    }
+  }
+
+  // cancel the armed poll, the completion of it will be ignored by generation mismatch
+  void cancel_poll(fd_entry& entry, socket_native_type fd)
+  {
+    if (entry.poll_armed)
+    {
+      auto sqe = get_sqe();
+      if (sqe)
+      {
+        sqe->opcode    = IORING_OP_POLL_REMOVE;
+        sqe->fd        = -1;
+        sqe->addr      = make_user_data(fd, op_poll, entry.poll_gen);
+        sqe->user_data = internal_user_data;
+      }
+      entry.poll_armed = false;
+    }
+    entry.poll_gen = (entry.poll_gen + 1) & max_gen;
+  }
+
+  void arm_poll(socket_native_type fd, fd_entry& entry)
+  {
+    auto sqe = get_sqe();
+    if (!sqe)
+    { // try again at next poll
+      pend(fd, entry);
+      return;
+    }
+    uint32_t poll_events = to_poll_events(entry.poll_events());
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    poll_events = (poll_events << 16) | (poll_events >> 16);
+#endif
+    sqe->opcode        = IORING_OP_POLL_ADD;
+    sqe->fd            = fd;
+    sqe->poll32_events = poll_events;
+    sqe->user_data     = make_user_data(fd, op_poll, entry.poll_gen);
+    entry.poll_armed   = true;
+  }
+
+  void arm_multishot(socket_native_type fd, fd_entry& entry)
+  {
+#if YASIO__HAS_IO_URING_COMPLETION
+    // the recv without provided buffer fails with ENOBUFS, wait the buffers taken by transports
+    io_uring_sqe* sqe = nullptr;
+    if ((entry.mode == fd_stream && bufs_free_ == 0) || !(sqe = get_sqe()))
+    {
+      pend(fd, entry);
+      return;
+    }
+    if (entry.mode == fd_stream)
+    {
+      sqe->opcode    = IORING_OP_RECV;
+      sqe->ioprio    = IORING_RECV_MULTISHOT;
+      sqe->flags     = IOSQE_BUFFER_SELECT;
+      sqe->buf_group = recv_buf_group;
+      sqe->user_data = make_user_data(fd, op_recv, entry.gen);
+    }
+    else
+    {
+      sqe->opcode       = IORING_OP_ACCEPT;
+      sqe->ioprio       = IORING_ACCEPT_MULTISHOT;
+      sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+      sqe->user_data    = make_user_data(fd, op_accept, entry.gen);
+    }
+    sqe->fd               = fd;
+    entry.multishot_armed = true;
+#endif
+  }
+
+  void reap_completions()
+  {
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head)
+    {
+      auto& cqe = cqes_[head & cq_mask_];
+      if (cqe.user_data & internal_user_data)
+        continue;
+      auto fd  = static_cast<socket_native_type>(cqe.user_data & 0xffffffff);
+      auto op  = static_cast<unsigned>(cqe.user_data >> 61);
+      auto gen = static_cast<unsigned>(cqe.user_data >> 32) & max_gen;
+      if (op == op_poll)
+        handle_poll(fd, gen, cqe.res);
+      else
+        handle_completion(fd, op, gen, cqe);
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  }
+
+  void handle_poll(socket_native_type fd, unsigned gen, int res)
+  {
+    if (fd >= static_cast<int>(entries_.size()))
+      return;
+    auto& entry = entries_[fd];
+    if (entry.poll_gen != gen || !entry.poll_armed)
+      return; // stale completion of cancelled poll
+
+    entry.poll_armed = false;
+    if (entry.poll_events())
+      pend(fd, entry);
+    if (res > 0)
+      set_ready(fd, from_poll_events(res));
+  }
+
+  void handle_completion(socket_native_type fd, unsigned op, unsigned gen, const io_uring_cqe& cqe)
+  {
+#if YASIO__HAS_IO_URING_COMPLETION
+    int res = cqe.res;
+    if (cqe.flags & IORING_CQE_F_BUFFER)
+      --bufs_free_;
+    auto entry = fd < static_cast<int>(entries_.size()) && entries_[fd].gen == gen ? &entries_[fd] : nullptr;
+    if (!entry || entry->mode == fd_poll)
+    { // the socket released, give back the resources of stale completion
+      if (cqe.flags & IORING_CQE_F_BUFFER)
+        recycle_buf(static_cast<int>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+      else if (op == op_accept && res >= 0)
+        ::close(res);
+      return;
+    }
+    if (op == op_send)
+    {
+      entry->send_state  = send_completed;
+      entry->send_result = res;
+      set_ready(fd, YEM_POLLOUT);
+      return;
+    }
+
+    if (res >= 0)
+    {
+      if (op == op_accept)
+        entry->accepted.push_back(res);
+      else if (res > 0)
+        entry->rx_bufs.push_back(rx_buf{static_cast<int>(cqe.flags >> IORING_CQE_BUFFER_SHIFT), res, 0});
+      else
+        entry->closed = true; // the peer closed
+    }
+    else if (op == op_recv ? res != -ENOBUFS : (res == -EINVAL || res == -EBADF))
+    { // the recv without buffer and the accept failure such as EMFILE are transient, the multishot is re-armed
+      entry->closed = true;
+      entry->error  = -res;
+    }
+    if (!(cqe.flags & IORING_CQE_F_MORE))
+    { // the multishot terminated, re-arm it at next poll unless socket closed
+      entry->multishot_armed = false;
+      if (!entry->closed)
+        pend(fd, *entry);
+    }
+    if (entry->rx_ready())
+      set_rx_ready(fd, *entry);
+#else
+    (void)fd, (void)op, (void)gen, (void)cqe;
+#endif
+  }
+
+  static uint32_t to_poll_events(int events)
+  {
+    uint32_t poll_events = 0;
+    if (events & YEM_POLLIN)
+      poll_events |= POLLIN;
+    if (events & YEM_POLLOUT)
+      poll_events |= POLLOUT;
+    if (events & YEM_POLLERR)
+      poll_events |= POLLPRI;
+    return poll_events;
+  }
+  static int from_poll_events(int poll_events)
+  {
+    int events = 0;
+    if (poll_events & POLLIN)
+      events |= YEM_POLLIN;
+    if (poll_events & POLLOUT)
+      events |= YEM_POLLOUT;
+    if (poll_events & (POLLERR | POLLHUP))
+      events |= (YEM_POLLIN | YEM_POLLOUT | YEM_POLLERR); // select reports error as readable & writable
+    if (poll_events & POLLPRI)
+      events |= YEM_POLLERR;
+    return events;
+  }
+
+  int ring_fd_      = -1;
+  void* ring_ptr_   = MAP_FAILED;
+  size_t ring_size_ = 0;
+  void* sqes_       = MAP_FAILED;
+  size_t sqes_size_ = 0;
+
+  unsigned* sq_head_      = nullptr;
+  unsigned* sq_tail_      = nullptr;
+  unsigned sq_mask_       = 0;
+  unsigned sq_size_       = 0;
+  unsigned sq_tail_local_ = 0;
+
+  unsigned* cq_head_  = nullptr;
+  unsigned* cq_tail_  = nullptr;
+  unsigned cq_mask_   = 0;
+  io_uring_cqe* cqes_ = nullptr;
+
+  // whether the completion sockets supported
+  bool completion_ok_ = false;
+
+  // the recv buffers, created when first stream enabled
+  char* bufs_         = static_cast<char*>(MAP_FAILED);
+  unsigned bufs_free_ = 0; // the buffers provided to kernel
+  std::vector<int> recycled_bids_;
+
+  // the poll & completion states of descriptors, index by fd
+  std::vector<fd_entry> entries_;
+
+  // the descriptors need arm poll or multishot at next poll_io
+  std::vector<socket_native_type> pending_fds_;
+  std::vector<socket_native_type> arming_fds_;
+
+  // the completion sockets have data or connections not taken, or closed
+  std::vector<socket_native_type> rx_fds_;
+
+  // the ready descriptors & flags of last poll, index by fd
+  std::vector<socket_native_type> ready_fds_;
+  std::vector<uint8_t> revents_;
+
+  std::unique_ptr<epoll_io_watcher> fallback_;
+};
+} // namespace inet
+} // namespace yasio
+
+#endif
@@ -0,0 +1,76 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A multi-platform support c++11 library with focus on asynchronous socket I/O for any
+// client application.
+//////////////////////////////////////////////////////////////////////////////////////////
+/*
+The MIT License (MIT)
+
+Copyright (c) 2012-2021 HALX99
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef YASIO__IO_WATCHER_HPP
+#define YASIO__IO_WATCHER_HPP
+
+#include "yasio/detail/config.hpp"
+
+namespace yasio
+{
+YASIO__NS_INLINE
+namespace inet
+{
+enum
+{ // event mask
+  YEM_POLLIN  = 1,
+  YEM_POLLOUT = 2,
+  YEM_POLLERR = 4,
+};
+} // namespace inet
+} // namespace yasio
+
+#if defined(__linux__) && defined(YASIO_ENABLE_IO_URING)
+#  define YASIO__HAS_IO_URING 1
+#  define YASIO__HAS_EPOLL 1
+#  include "yasio/detail/io_uring_io_watcher.hpp"
+#elif defined(__linux__) && !defined(YASIO_DISABLE_EPOLL)
+#  define YASIO__HAS_IO_URING 0
+#  define YASIO__HAS_EPOLL 1
+#  include "yasio/detail/epoll_io_watcher.hpp"
+#else
+#  define YASIO__HAS_IO_URING 0
+#  define YASIO__HAS_EPOLL 0
+#  include "yasio/detail/select_io_watcher.hpp"
+#endif
+
+namespace yasio
+{
+YASIO__NS_INLINE
+namespace inet
+{
+#if YASIO__HAS_IO_URING
+typedef io_uring_io_watcher io_watcher;
+#elif YASIO__HAS_EPOLL
+typedef epoll_io_watcher io_watcher;
+#else
+typedef select_io_watcher io_watcher;
+#endif
+} // namespace inet
+} // namespace yasio
+
+#endif
@@ -0,0 +1,166 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A multi-platform support c++11 library with focus on asynchronous socket I/O for any 
+// client application.
+//////////////////////////////////////////////////////////////////////////////////////////
+/*
+The MIT License (MIT)
+
+Copyright (c) 2012-2021 HALX99
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+// packet_pool.hpp: size-classed recycling pool for received packet buffers
+#ifndef YASIO__PACKET_POOL_HPP
+#define YASIO__PACKET_POOL_HPP
+
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "yasio/detail/config.hpp"
+
+namespace yasio
+{
+struct packet_pool_stats {
+  unsigned long long hits;     // acquire served by a recycled buffer
+  unsigned long long misses;   // acquire had to allocate a new buffer
+  unsigned long long recycled; // buffers returned to the pool
+  unsigned long long dropped;  // buffers released to the heap, class full or out of range
+};
+
+/*
+ * The power-of-two classes [min_class_size, max_class_size] each keep up to YASIO_PACKET_POOL_CAPACITY
+ * free buffers, larger buffers always come from and go back to the heap.
+ */
+class packet_pool {
+public:
+  enum : size_t
+  {
+    min_class_shift = 7,
+    max_class_shift = 16,
+    min_class_size  = static_cast<size_t>(1) << min_class_shift,
+    max_class_size  = static_cast<size_t>(1) << max_class_shift,
+    class_count     = max_class_shift - min_class_shift + 1,
+  };
+
+  static packet_pool& instance()
+  {
+    static packet_pool s_pool;
+    return s_pool;
+  }
+
+  // Gets an empty buffer which can hold at least `size` bytes without reallocation.
+  std::vector<char> acquire(size_t size)
+  {
+    std::vector<char> buf;
+    if (size <= max_class_size)
+    {
+      auto index = class_index_ceil(size);
+      {
+        auto& slot = classes_[index];
+        std::lock_guard<std::mutex> lck(slot.mtx_);
+        if (!slot.free_.empty())
+        {
+          buf = std::move(slot.free_.back());
+          slot.free_.pop_back();
+        }
+      }
+      if (buf.capacity() != 0)
+      {
+        ++hits_;
+        return buf;
+      }
+      size = min_class_size << index;
+    }
+    ++misses_;
+    buf.reserve(size);
+    return buf;
+  }
+
+  // Gives back a buffer, the content is discarded and `buf` is left empty.
+  void release(std::vector<char>& buf)
+  {
+    auto cap = buf.capacity();
+    if (cap == 0)
+      return;
+    if (cap >= min_class_size && cap <= max_class_size)
+    {
+      auto& slot = classes_[class_index_floor(cap)];
+      std::lock_guard<std::mutex> lck(slot.mtx_);
+      if (slot.free_.size() < YASIO_PACKET_POOL_CAPACITY)
+      {
+        buf.clear();
+        slot.free_.push_back(std::move(buf));
+        ++recycled_;
+        return;
+      }
+    }
+    ++dropped_;
+    std::vector<char>().swap(buf);
+  }
+
+  packet_pool_stats stats() const { return packet_pool_stats{hits_.load(), misses_.load(), recycled_.load(), dropped_.load()}; }
+
+  // Frees all pooled buffers, the counters are kept.
+  void purge()
+  {
+    for (auto& slot : classes_)
+    {
+      std::lock_guard<std::mutex> lck(slot.mtx_);
+      slot.free_.clear();
+    }
+  }
+
+private:
+  packet_pool() : hits_(0), misses_(0), recycled_(0), dropped_(0) {}
+  packet_pool(const packet_pool&) = delete;
+  packet_pool& operator=(const packet_pool&) = delete;
+
+  // the smallest class which can hold size bytes
+  static size_t class_index_ceil(size_t size)
+  {
+    size_t index = 0;
+    while ((min_class_size << index) < size)
+      ++index;
+    return index;
+  }
+  // the largest class whose size not exceed capacity
+  static size_t class_index_floor(size_t cap)
+  {
+    size_t index = 0;
+    while (index + 1 < class_count && (min_class_size << (index + 1)) <= cap)
+      ++index;
+    return index;
+  }
+
+  struct size_class {
+    std::mutex mtx_;
+    std::vector<std::vector<char>> free_;
+  };
+  size_class classes_[class_count];
+
+  std::atomic<unsigned long long> hits_;
+  std::atomic<unsigned long long> misses_;
+  std::atomic<unsigned long long> recycled_;
+  std::atomic<unsigned long long> dropped_;
+};
+} // namespace yasio
+
+#endif
@@ -18,6 +18,7 @@
 #define YASIO__SELECT_INTERRUPTER_HPP
 
 #include "yasio/compiler/feature_test.hpp"
+#include <atomic>
 
 #if defined(_WIN32)
 #  include "socket_select_interrupter.hpp"
@@ -33,12 +34,51 @@ YASIO__NS_INLINE
 namespace inet
 {
 
+/*
+** The interrupter which coalesces wakeups: the io_service thread marks itself sleeping before
+** blocking on select, interrupt only performs the wakeup syscall when the io_service thread is
+** sleeping and no wakeup pending, so at most one syscall per io_service sleep.
+*/
+template <typename _Ty> class coalesced_select_interrupter : public _Ty {
+  enum
+  {
+    awake,
+    sleeping,
+    notified,
+  };
+
+public:
+  // Interrupt the select call, thread safe.
+  void interrupt()
+  {
+    if (state_.exchange(notified) == sleeping)
+      _Ty::interrupt();
+  }
+
+  // Call at io_service thread before select, returns false when interrupt was called after
+  // last wait, the select call shouldn't block.
+  bool prepare_wait()
+  {
+    int expected = awake;
+    if (state_.compare_exchange_strong(expected, sleeping))
+      return true;
+    state_.store(awake);
+    return false;
+  }
+
+  // Call at io_service thread after select returned.
+  void finish_wait() { state_.store(awake); }
+
+private:
+  std::atomic<int> state_{awake};
+};
+
 #if defined(_WIN32)
-typedef socket_select_interrupter select_interrupter;
+typedef coalesced_select_interrupter<socket_select_interrupter> select_interrupter;
 #elif defined(__linux__)
-typedef eventfd_select_interrupter select_interrupter;
+typedef coalesced_select_interrupter<eventfd_select_interrupter> select_interrupter;
 #else
-typedef pipe_select_interrupter select_interrupter;
+typedef coalesced_select_interrupter<pipe_select_interrupter> select_interrupter;
 #endif
 
 } // namespace inet
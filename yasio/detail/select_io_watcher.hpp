@@ -0,0 +1,165 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A multi-platform support c++11 library with focus on asynchronous socket I/O for any
+// client application.
+//////////////////////////////////////////////////////////////////////////////////////////
+/*
+The MIT License (MIT)
+
+Copyright (c) 2012-2021 HALX99
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef YASIO__SELECT_IO_WATCHER_HPP
+#define YASIO__SELECT_IO_WATCHER_HPP
+
+#include "yasio/detail/utils.hpp"
+#include "yasio/xxsocket.hpp"
+
+namespace yasio
+{
+YASIO__NS_INLINE
+namespace inet
+{
+// The portable watcher, the max descriptors is limited by FD_SETSIZE
+class select_io_watcher {
+public:
+  select_io_watcher()
+  {
+    FD_ZERO(&fds_array_[read_op]);
+    FD_ZERO(&fds_array_[write_op]);
+    FD_ZERO(&fds_array_[except_op]);
+    ::memcpy(this->ready_fds_array_, this->fds_array_, sizeof(this->fds_array_));
+  }
+
+  void mod_event(socket_native_type fd, int add_events, int remove_events)
+  {
+#if !defined(_WIN32)
+    const bool registered = is_registered(fd);
+#endif
+    if (add_events)
+    {
+      if (add_events & YEM_POLLIN)
+        FD_SET(fd, &(fds_array_[read_op]));
+      if (add_events & YEM_POLLOUT)
+        FD_SET(fd, &(fds_array_[write_op]));
+      if (add_events & YEM_POLLERR)
+        FD_SET(fd, &(fds_array_[except_op]));
+      if (max_nfds_ < static_cast<int>(fd) + 1)
+        max_nfds_ = static_cast<int>(fd) + 1;
+    }
+    if (remove_events)
+    {
+      if (remove_events & YEM_POLLIN)
+        FD_CLR(fd, &(fds_array_[read_op]));
+      if (remove_events & YEM_POLLOUT)
+        FD_CLR(fd, &(fds_array_[write_op]));
+      if (remove_events & YEM_POLLERR)
+        FD_CLR(fd, &(fds_array_[except_op]));
+    }
+#if !defined(_WIN32)
+    if (!registered && is_registered(fd))
+      registered_fds_.push_back(fd);
+    else if (registered && !is_registered(fd))
+    { // the descriptor removed, shrink max_nfds if it's the max one
+      auto it = std::find(registered_fds_.begin(), registered_fds_.end(), fd);
+      *it     = registered_fds_.back();
+      registered_fds_.pop_back();
+      if (max_nfds_ == static_cast<int>(fd) + 1)
+        max_nfds_ = registered_fds_.empty() ? 0 : static_cast<int>(*std::max_element(registered_fds_.begin(), registered_fds_.end())) + 1;
+    }
+#endif
+  }
+
+  // @retval: the number of descriptors ready, 0: timeout, < 0: error
+  int poll_io(highp_time_t wait_duration)
+  {
+    ::memcpy(this->ready_fds_array_, this->fds_array_, sizeof(this->fds_array_));
+    timeval waitd_tv = {(decltype(timeval::tv_sec))(wait_duration / 1000000), (decltype(timeval::tv_usec))(wait_duration % 1000000)};
+    int retval = ::select(this->max_nfds_, &(ready_fds_array_[read_op]), &(ready_fds_array_[write_op]), nullptr, &waitd_tv);
+    nready_    = (std::max)(retval, 0);
+    return retval;
+  }
+
+  int is_ready(socket_native_type fd, int events) const
+  {
+    int revents = 0;
+    if ((events & YEM_POLLIN) && FD_ISSET(fd, &(ready_fds_array_[read_op])))
+      revents |= YEM_POLLIN;
+    if ((events & YEM_POLLOUT) && FD_ISSET(fd, &(ready_fds_array_[write_op])))
+      revents |= YEM_POLLOUT;
+    return revents;
+  }
+
+  // traverse the ready descriptors of last poll, the descriptor may be visited twice on win32
+  template <typename _Fty> void for_each_ready(_Fty&& func) const
+  {
+#if defined(_WIN32)
+    // the winsock fd_set is a array of sockets
+    for (u_int i = 0; i < ready_fds_array_[read_op].fd_count; ++i)
+      func(ready_fds_array_[read_op].fd_array[i]);
+    for (u_int i = 0; i < ready_fds_array_[write_op].fd_count; ++i)
+      func(ready_fds_array_[write_op].fd_array[i]);
+#else
+    // visit the registered descriptors only, stop when all ready ones visited, the select counts read and write readiness separately
+    int nready = nready_;
+    for (size_t i = 0; i < registered_fds_.size() && nready > 0; ++i)
+    {
+      auto fd     = registered_fds_[i];
+      int revents = is_ready(fd, YEM_POLLIN | YEM_POLLOUT);
+      if (revents)
+      {
+        nready -= (revents == (YEM_POLLIN | YEM_POLLOUT)) ? 2 : 1;
+        func(fd);
+      }
+    }
+#endif
+  }
+
+
+private:
+  enum
+  {
+    read_op,
+    write_op,
+    except_op,
+    max_ops,
+  };
+  fd_set fds_array_[max_ops];
+  fd_set ready_fds_array_[max_ops];
+
+#if !defined(_WIN32)
+  bool is_registered(socket_native_type fd) const
+  {
+    return FD_ISSET(fd, &(fds_array_[read_op])) || FD_ISSET(fd, &(fds_array_[write_op])) || FD_ISSET(fd, &(fds_array_[except_op]));
+  }
+
+  // the descriptors in fds_array_, avoid traverse 0~max_nfds_ to find the ready ones
+  std::vector<socket_native_type> registered_fds_;
+#endif
+
+  // the max nfds for socket.select, must be max_fd + 1
+  int max_nfds_ = 0;
+
+  // the number of ready descriptors of last poll
+  int nready_ = 0;
+};
+} // namespace inet
+} // namespace yasio
+
+#endif
@@ -0,0 +1,265 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A multi-platform support c++11 library with focus on asynchronous socket I/O for any
+// client application.
+//////////////////////////////////////////////////////////////////////////////////////////
+/*
+The MIT License (MIT)
+
+Copyright (c) 2012-2021 HALX99
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef YASIO__TIMING_WHEEL_HPP
+#define YASIO__TIMING_WHEEL_HPP
+
+#include <stdint.h>
+#include "yasio/detail/utils.hpp"
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace yasio
+{
+// The intrusive node of timing_wheel
+struct wheel_node {
+  wheel_node* prev_ = nullptr;
+  wheel_node* next_ = nullptr;
+  int slot_         = -1; // the slot of timing_wheel, -1: not linked
+  highp_time_t expire_tick_ = 0;
+
+  bool linked() const { return slot_ != -1; }
+};
+
+/*
+** The hierarchical timing wheel, O(1) insert, remove and expire.
+** remark:
+**   a. The level l has 64 slots, each slot spans 64^l ticks, the slots of upper levels are
+**      cascaded to lower levels when the current tick reaches them.
+**   b. The non-empty slots are tracked by a bitmap per level, so advance and next_tick
+**      skip the empty slots instead of stepping tick by tick.
+**   c. Not thread safe.
+*/
+class timing_wheel {
+public:
+  enum
+  {
+    slot_bits   = 6,
+    slot_count  = 1 << slot_bits,
+    slot_mask   = slot_count - 1,
+    level_count = 5, // 64^5 ticks, about 12.4 days when tick is 1ms
+    due_slot    = level_count * slot_count,
+  };
+
+  timing_wheel()
+  {
+    for (auto& slot : slots_)
+      slot.prev_ = slot.next_ = &slot;
+  }
+  timing_wheel(const timing_wheel&) = delete;
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  highp_time_t current_tick() const { return cur_tick_; }
+
+  // Insert node expire at the tick, the node expired already is linked to due list
+  void insert(wheel_node* node, highp_time_t expire_tick)
+  {
+    node->expire_tick_ = expire_tick;
+    link(node, slot_of(expire_tick));
+    ++size_;
+  }
+
+  void remove(wheel_node* node)
+  {
+    if (node->linked())
+    {
+      unlink(node);
+      --size_;
+    }
+  }
+
+  // Gets the next tick should advance to, -1: the wheel is empty
+  highp_time_t next_tick() const
+  {
+    if (size_ == 0)
+      return -1;
+    return slot_empty(due_slot) ? next_slot_tick() : cur_tick_;
+  }
+
+  // Advance the wheel to the tick, the expired nodes are moved to the due list
+  void advance(highp_time_t tick)
+  {
+    for (;;)
+    {
+      highp_time_t next = next_slot_tick();
+      if (next == -1 || next > tick)
+        break;
+
+      cur_tick_ = next;
+
+      // cascade the upper level slots which reach to current tick
+      for (int level = level_count - 1; level > 0; --level)
+      {
+        auto index = static_cast<int>((cur_tick_ >> (level * slot_bits)) & slot_mask);
+        if (bitmaps_[level] & (1ULL << index))
+        {
+          auto& slot = slots_[level * slot_count + index];
+          while (slot.next_ != &slot)
+          {
+            auto node = slot.next_;
+            unlink(node);
+            link(node, slot_of(node->expire_tick_));
+          }
+        }
+      }
+
+      // expire the level 0 slot
+      auto index = static_cast<int>(cur_tick_ & slot_mask);
+      if (bitmaps_[0] & (1ULL << index))
+      {
+        auto& slot = slots_[index];
+        while (slot.next_ != &slot)
+        {
+          auto node = slot.next_;
+          unlink(node);
+          link(node, due_slot);
+        }
+      }
+    }
+    if (cur_tick_ < tick)
+      cur_tick_ = tick;
+  }
+
+  // Pop a expired node from due list, nullptr: no more expired nodes
+  wheel_node* pop_due()
+  {
+    auto& slot = slots_[due_slot];
+    if (slot.next_ == &slot)
+      return nullptr;
+    auto node = slot.next_;
+    unlink(node);
+    --size_;
+    return node;
+  }
+
+  // Remove all nodes, call func for each node
+  template <typename _Fty> void clear(_Fty&& func)
+  {
+    for (auto& slot : slots_)
+    {
+      while (slot.next_ != &slot)
+      {
+        auto node = slot.next_;
+        unlink(node);
+        func(node);
+      }
+    }
+    size_ = 0;
+  }
+
+private:
+  // Gets the start tick of the nearest non-empty slot, -1: all slots are empty
+  highp_time_t next_slot_tick() const
+  {
+    highp_time_t tick = -1;
+    for (int level = 0; level < level_count; ++level)
+    {
+      if (!bitmaps_[level])
+        continue;
+      auto shift          = level * slot_bits;
+      auto base           = cur_tick_ >> shift;
+      auto offset         = static_cast<int>((base + 1) & slot_mask);
+      auto bitmap         = rotr(bitmaps_[level], offset);
+      highp_time_t bucket = base + 1 + ctz(bitmap);
+      highp_time_t start  = bucket << shift;
+      if (tick == -1 || start < tick)
+        tick = start;
+    }
+    return tick;
+  }
+
+  int slot_of(highp_time_t expire_tick) const
+  {
+    if (expire_tick <= cur_tick_)
+      return due_slot;
+    for (int level = 0; level < level_count; ++level)
+    {
+      auto shift = level * slot_bits;
+      if ((expire_tick >> shift) - (cur_tick_ >> shift) < slot_count)
+        return level * slot_count + static_cast<int>((expire_tick >> shift) & slot_mask);
+    }
+    // out of range, put it at the farthest slot, it will be cascaded again
+    auto shift = (level_count - 1) * slot_bits;
+    return (level_count - 1) * slot_count + static_cast<int>(((cur_tick_ >> shift) + slot_count - 1) & slot_mask);
+  }
+
+  bool slot_empty(int slot) const { return slots_[slot].next_ == &slots_[slot]; }
+
+  void link(wheel_node* node, int slot)
+  {
+    auto& head        = slots_[slot];
+    node->prev_       = head.prev_;
+    node->next_       = &head;
+    head.prev_->next_ = node;
+    head.prev_        = node;
+    node->slot_       = slot;
+    if (slot != due_slot)
+      bitmaps_[slot >> slot_bits] |= (1ULL << (slot & slot_mask));
+  }
+
+  void unlink(wheel_node* node)
+  {
+    node->prev_->next_ = node->next_;
+    node->next_->prev_ = node->prev_;
+    int slot           = node->slot_;
+    if (slot != due_slot && slot_empty(slot))
+      bitmaps_[slot >> slot_bits] &= ~(1ULL << (slot & slot_mask));
+    node->prev_ = node->next_ = nullptr;
+    node->slot_               = -1;
+  }
+
+  static uint64_t rotr(uint64_t value, int shift) { return shift ? (value >> shift) | (value << (64 - shift)) : value; }
+
+  static int ctz(uint64_t value)
+  {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+#  if defined(_WIN64)
+    _BitScanForward64(&index, value);
+#  else
+    if (_BitScanForward(&index, static_cast<unsigned long>(value)))
+      return static_cast<int>(index);
+    _BitScanForward(&index, static_cast<unsigned long>(value >> 32));
+    index += 32;
+#  endif
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(value);
+#endif
+  }
+
+  wheel_node slots_[level_count * slot_count + 1]; // the last one is due list
+  uint64_t bitmaps_[level_count] = {0};
+  highp_time_t cur_tick_         = 0;
+  size_t size_                   = 0;
+};
+} // namespace yasio
+
+#endif
@@ -532,6 +532,11 @@ int xxsocket::accept_n(socket_native_type& new_sock) const
   for (;;)
   {
     // Accept the waiting connection.
+#if defined(__linux__) && (!defined(__ANDROID__) || __ANDROID_API__ >= 21)
+    new_sock = ::accept4(this->fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (new_sock != invalid_socket)
+      return 0;
+#else
     new_sock = ::accept(this->fd, nullptr, nullptr);
 
     // Check if operation succeeded.
@@ -540,6 +545,7 @@ int xxsocket::accept_n(socket_native_type& new_sock) const
       xxsocket::set_nonblocking(new_sock, true);
       return 0;
     }
+#endif
 
     auto error = get_last_errno();
     // Retry operation if interrupted by signal.
@@ -725,6 +731,21 @@ int xxsocket::recv_n(socket_native_type s, void* buf, int len, std::chrono::micr
 int xxsocket::send(const void* buf, int len, int flags) const { return static_cast<int>(::send(this->fd, (const char*)buf, len, flags)); }
 int xxsocket::send(socket_native_type s, const void* buf, int len, int flags) { return static_cast<int>(::send(s, (const char*)buf, len, flags)); }
 
+int xxsocket::sendv(const iobuf* bufs, int count, int flags) const { return xxsocket::sendv(this->fd, bufs, count, flags); }
+int xxsocket::sendv(socket_native_type s, const iobuf* bufs, int count, int flags)
+{
+#if defined(_WIN32)
+  DWORD bytes_transferred = 0;
+  int ret                 = ::WSASend(s, (LPWSABUF)bufs, static_cast<DWORD>(count), &bytes_transferred, static_cast<DWORD>(flags), nullptr, nullptr);
+  return ret == 0 ? static_cast<int>(bytes_transferred) : -1;
+#else
+  msghdr msg{};
+  msg.msg_iov    = (iovec*)bufs;
+  msg.msg_iovlen = count;
+  return static_cast<int>(::sendmsg(s, &msg, flags));
+#endif
+}
+
 int xxsocket::recv(void* buf, int len, int flags) const { return static_cast<int>(this->recv(this->fd, buf, len, flags)); }
 int xxsocket::recv(socket_native_type s, void* buf, int len, int flags) { return static_cast<int>(::recv(s, (char*)buf, len, flags)); }
 
@@ -81,9 +81,33 @@ typedef int socklen_t;
 #  endif
 #  include <sys/select.h>
 #  include <sys/socket.h>
+#  include <sys/uio.h>
 #  include <sys/un.h>
+#  include <limits.h>
 #  include <netinet/in.h>
 #  include <netinet/tcp.h>
+#  if defined(__linux__)
+#    include <netinet/udp.h>
+#    if !defined(UDP_SEGMENT)
+#      define UDP_SEGMENT 103 // linux 4.18+
+#    endif
+#    if !defined(UDP_GRO)
+#      define UDP_GRO 104 // linux 5.0+
+#    endif
+#    include <linux/errqueue.h>
+#    if !defined(SO_ZEROCOPY)
+#      define SO_ZEROCOPY 60 // linux 4.14+
+#    endif
+#    if !defined(MSG_ZEROCOPY)
+#      define MSG_ZEROCOPY 0x4000000
+#    endif
+#    if !defined(SO_EE_ORIGIN_ZEROCOPY)
+#      define SO_EE_ORIGIN_ZEROCOPY 5
+#    endif
+#    if !defined(SO_EE_CODE_ZEROCOPY_COPIED)
+#      define SO_EE_CODE_ZEROCOPY_COPIED 1
+#    endif
+#  endif
 #  include <net/if.h>
 #  include <arpa/inet.h>
 #  if !defined(SD_RECEIVE)
@@ -668,6 +692,31 @@ public:
 #endif
 };
 
+// The hash and exact equality of endpoint for unordered containers, compare family, address and port only
+struct endpoint_hash {
+  size_t operator()(const endpoint& ep) const
+  {
+    if (ep.af() == AF_INET)
+      return (static_cast<size_t>(ep.in4_.sin_addr.s_addr) * 31) ^ ep.in4_.sin_port;
+    size_t value = ep.in6_.sin6_port;
+    auto bytes   = reinterpret_cast<const unsigned char*>(&ep.in6_.sin6_addr);
+    for (size_t i = 0; i < sizeof(in6_addr); ++i)
+      value = value * 31 + bytes[i];
+    return value;
+  }
+};
+struct endpoint_equal_to {
+  bool operator()(const endpoint& lhs, const endpoint& rhs) const
+  {
+    if (lhs.af() != rhs.af())
+      return false;
+    if (lhs.af() == AF_INET)
+      return lhs.in4_.sin_addr.s_addr == rhs.in4_.sin_addr.s_addr && lhs.in4_.sin_port == rhs.in4_.sin_port;
+    return lhs.in6_.sin6_port == rhs.in6_.sin6_port && lhs.in6_.sin6_scope_id == rhs.in6_.sin6_scope_id &&
+           ::memcmp(&lhs.in6_.sin6_addr, &rhs.in6_.sin6_addr, sizeof(in6_addr)) == 0;
+  }
+};
+
 // supported internet protocol flags
 enum : u_short
 {
@@ -682,6 +731,34 @@ enum : u_short
 using namespace yasio::inet::ip;
 #endif
 
+/*
+** The buffer of gather io, same layout with WSABUF on win32 and iovec on others
+*/
+#if defined(_WIN32)
+struct iobuf : public WSABUF {
+  iobuf(const void* data, size_t size)
+  {
+    buf = (CHAR*)data;
+    len = static_cast<ULONG>(size);
+  }
+};
+// WSASend has no limit of buffer count
+#  define YASIO__IOV_MAX 1024
+#else
+struct iobuf : public iovec {
+  iobuf(const void* data, size_t size)
+  {
+    iov_base = (void*)data;
+    iov_len  = size;
+  }
+};
+#  if defined(IOV_MAX)
+#    define YASIO__IOV_MAX IOV_MAX
+#  else
+#    define YASIO__IOV_MAX 16 // _XOPEN_IOV_MAX
+#  endif
+#endif
+
 /*
 ** CLASS xxsocket: a posix socket wrapper
 */
@@ -889,6 +966,16 @@ public:
   YASIO__DECL int send(const void* buf, int len, int flags = 0) const;
   YASIO__DECL static int send(socket_native_type fd, const void* buf, int len, int flags = 0);
 
+  /* @brief: Sends multiple buffers on this connected socket with one gather call
+  ** @params:
+  **        bufs: the buffers to send, the count should not greater than YASIO__IOV_MAX
+  **
+  ** @returns:
+  **         Same as send.
+  */
+  YASIO__DECL int sendv(const iobuf* bufs, int count, int flags = 0) const;
+  YASIO__DECL static int sendv(socket_native_type fd, const iobuf* bufs, int count, int flags = 0);
+
   /* @brief: Receives data from this connected socket or a bound connectionless socket.
   ** @params: omit
   **
@@ -96,13 +96,6 @@ namespace inet
 {
 namespace
 {
-enum
-{ // event mask
-  YEM_POLLIN  = 1,
-  YEM_POLLOUT = 2,
-  YEM_POLLERR = 4,
-};
-
 enum
 { // op mask
   YOPM_OPEN  = 1,
@@ -145,6 +138,11 @@ namespace
 static highp_time_t yasio__min_wait_duration = 0LL;
 // the max transport alloc size
 static const size_t yasio__max_tsize = (std::max)({sizeof(io_transport_tcp), sizeof(io_transport_udp), sizeof(io_transport_ssl), sizeof(io_transport_kcp)});
+#if defined(__linux__)
+// the max segments and payload bytes of one UDP_SEGMENT send, see linux: UDP_MAX_SEGMENTS
+static const size_t yasio__udp_gso_max_segments = 64;
+static const size_t yasio__udp_gso_max_bytes    = 65507;
+#endif
 } // namespace
 struct yasio__global_state {
   enum
@@ -194,15 +192,17 @@ static yasio__global_state& yasio__shared_globals(const print_fn2_t& prt = nullp
   static yasio__global_state __global_state(prt);
   return __global_state;
 }
+// the tick of timing wheel which the timer expired at, round up to make sure timer never fire early
+static highp_time_t yasio__expire_tick(const std::chrono::time_point<steady_clock_t>& expire_time)
+{
+  auto expire_time_us = std::chrono::duration_cast<std::chrono::microseconds>(expire_time.time_since_epoch()).count();
+  return (expire_time_us + YASIO_TIMER_WHEEL_RESOLUTION - 1) / YASIO_TIMER_WHEEL_RESOLUTION;
+}
 } // namespace
 
 /// highp_timer
 void highp_timer::async_wait(io_service& service, timer_cb_t cb) { service.schedule_timer(this, std::move(cb)); }
-void highp_timer::cancel(io_service& service)
-{
-  if (!expired())
-    service.remove_timer(this);
-}
+void highp_timer::cancel(io_service& service) { service.remove_timer(this); }
 
 /// io_send_op
 int io_send_op::perform(io_transport* transport, const void* buf, int n) { return transport->write_cb_(buf, n, nullptr); }
@@ -364,6 +364,46 @@ int io_channel::__builtin_decode_len(void* d, int n)
   }
   return n;
 }
+int io_channel::__builtin_decode_varint(void* d, int n)
+{
+  int loffset = (std::max)(uparams_.length_field_offset, 0);
+  auto p      = static_cast<const uint8_t*>(d) + loffset;
+  uint32_t value = 0;
+  // the int32 is encoded to 5 bytes at most, see obstream::write_ix
+  for (int i = 0; i < 5; ++i)
+  {
+    if (loffset + i >= n)
+      return 0;
+    value |= static_cast<uint32_t>(p[i] & 0x7fu) << (7 * i);
+    if (p[i] < 0x80u)
+    {
+      int64_t len = static_cast<int64_t>(loffset) + i + 1 + value + uparams_.length_adjustment;
+      return (len > 0 && len <= uparams_.max_frame_length) ? static_cast<int>(len) : -1;
+    }
+  }
+  return -1;
+}
+int io_channel::__builtin_decode_delim(void* d, int n, int& scanned)
+{
+  auto first = static_cast<const char*>(d);
+  int dlen   = static_cast<int>(delimiter_.size());
+  for (int pos = scanned; n - pos >= dlen;)
+  { // memchr is vectorized by libc, only the candidates are compared
+    auto hit = static_cast<const char*>(::memchr(first + pos, delimiter_[0], n - pos - dlen + 1));
+    if (!hit)
+      break;
+    if (dlen == 1 || ::memcmp(hit + 1, delimiter_.data() + 1, dlen - 1) == 0)
+    {
+      scanned = 0;
+      int len = static_cast<int>(hit - first) + dlen;
+      return len <= uparams_.max_frame_length ? len : -1;
+    }
+    pos = static_cast<int>(hit - first) + 1;
+  }
+  // the tail shorter than delimiter may be a partial delimiter, scan it again at next read
+  scanned = (std::max)(n - dlen + 1, 0);
+  return n < (std::min)(uparams_.max_frame_length, YASIO_INET_BUFFER_SIZE) ? 0 : -1;
+}
 // -------------------- io_transport ---------------------
 io_transport::io_transport(io_channel* ctx, std::shared_ptr<xxsocket>& s) : ctx_(ctx)
 {
@@ -378,10 +418,68 @@ int io_transport::write(std::vector<char>&& buffer, completion_cb_t&& handler)
 {
   int n = static_cast<int>(buffer.size());
   send_queue_.emplace(cxx14::make_unique<io_send_op>(std::move(buffer), std::move(handler)));
-  get_service().interrupt();
+  get_service().wakeup(this);
   return n;
 }
-int io_transport::do_read(int revent, int& error, highp_time_t&) { return revent ? this->call_read(buffer_ + offset_, sizeof(buffer_) - offset_, error) : 0; }
+int io_transport::write_shared(const shared_buffer_t& buffer, completion_cb_t&& handler)
+{
+  int n = static_cast<int>(buffer->size());
+  send_queue_.emplace(cxx14::make_unique<io_send_op>(buffer, std::move(handler)));
+  get_service().wakeup(this);
+  return n;
+}
+int io_transport::do_read(int revent, int& error, highp_time_t&)
+{
+  if (!revent)
+    return 0;
+  if (rchunk_)
+  {
+    if (offset_ == 0 && rchunk_.use_count() == 1)
+      rpos_ = 0; // no frame view refers the chunk, read from head
+    else if (offset_ == rcapacity())
+      reserve_chunk(offset_ + 1, offset_);
+  }
+  return this->call_read(rdata() + offset_, rcapacity() - offset_, error);
+}
+void io_transport::reserve_chunk(int need, int bytes_used)
+{
+  if (rchunk_ && rpos_ + need <= rchunk_size_)
+    return;
+  int size = (std::max)(need, YASIO_INET_BUFFER_SIZE);
+  if (rchunk_.use_count() == 1 && size <= rchunk_size_)
+  { // no frame view refers the chunk, move the partial frame to head
+    if (bytes_used > 0)
+      ::memmove(rchunk_.get(), rchunk_.get() + rpos_, bytes_used);
+  }
+  else
+  {
+    std::shared_ptr<char> chunk(new char[size], std::default_delete<char[]>());
+    if (bytes_used > 0)
+      ::memcpy(chunk.get(), rdata(), bytes_used);
+    rchunk_      = std::move(chunk);
+    rchunk_size_ = size;
+  }
+  rpos_ = 0;
+}
+#if defined(YASIO_ENABLE_SHARED_RECV_BUFFER)
+void io_transport::attach_buffer(char* buffer)
+{
+  buffer_ = buffer;
+  if (offset_ > 0 && !rchunk_)
+    ::memcpy(buffer_, pending_.data(), offset_);
+}
+void io_transport::detach_buffer()
+{
+  if (!rchunk_)
+  {
+    if (offset_ > 0)
+      pending_.assign(buffer_, buffer_ + offset_);
+    else if (pending_.capacity() != 0)
+      std::vector<char>().swap(pending_); // idle transport holds nothing
+  }
+  buffer_ = nullptr;
+}
+#endif
 bool io_transport::do_write(highp_time_t& wait_duration)
 {
   bool ret = false;
@@ -390,16 +488,18 @@ bool io_transport::do_write(highp_time_t& wait_duration)
     if (!socket_->is_open())
       break;
 
-    int error = 0;
-    auto wrap = send_queue_.peek();
-    if (wrap)
+    // send until the kernel buffer full or the budget of one loop exhausted
+    int error = 0, n = 0, bytes_transferred = 0;
+    for (io_send_op* op; bytes_transferred < YASIO_MAX_SEND_BYTES_PER_LOOP && (op = send_queue_.peek()) != nullptr; bytes_transferred += n)
     {
-      auto& v = *wrap;
-      if (call_write(v.get(), error) < 0)
-      {
-        this->set_last_errno(error, yasio::io_base::error_stage::WRITE);
+      n = call_writev(op, error);
+      if (n <= 0)
         break;
-      }
+    }
+    if (n < 0)
+    {
+      this->set_last_errno(error, yasio::io_base::error_stage::WRITE);
+      break;
     }
 
     bool no_wevent = send_queue_.empty();
@@ -408,7 +508,9 @@ bool io_transport::do_write(highp_time_t& wait_duration)
       no_wevent = (error != EWOULDBLOCK && error != EAGAIN && error != ENOBUFS);
       if (!no_wevent)
       { // system kernel buffer full
-        if (!pollout_registerred_)
+        if (shared_socket_) // the socket polled by server channel, just retry at next loop
+          wait_duration = yasio__min_wait_duration;
+        else if (!pollout_registerred_)
         {
           get_service().register_descriptor(socket_->native_handle(), YEM_POLLOUT);
           pollout_registerred_ = true;
@@ -451,12 +553,12 @@ int io_transport::call_read(void* data, int size, int& error)
 }
 int io_transport::call_write(io_send_op* op, int& error)
 {
-  int n = op->perform(this, op->buffer_.data() + op->offset_, static_cast<int>(op->buffer_.size() - op->offset_));
+  int n = op->perform(this, op->data() + op->offset_, static_cast<int>(op->size() - op->offset_));
   if (n > 0)
   {
     // #performance: change offset only, remain data will be send at next frame.
     op->offset_ += n;
-    if (op->offset_ == op->buffer_.size())
+    if (op->offset_ == op->size())
       this->complete_op(op, 0);
   }
   else if (n < 0)
@@ -473,9 +575,46 @@ int io_transport::call_write(io_send_op* op, int& error)
   }
   return n;
 }
+int io_transport::call_writev(io_send_op* op, int& error)
+{
+  if (!writev_cb_)
+    return call_write(op, error);
+
+  auto& bufs = get_service().iobufs_;
+  bufs.clear();
+  for (size_t bytes = 0; op != nullptr && bufs.size() < YASIO__IOV_MAX && bytes < YASIO_MAX_SEND_BYTES_PER_LOOP; op = send_queue_.next(op))
+  {
+    if (zerocopy_threshold_ && !bufs.empty() && op->size() >= zerocopy_threshold_)
+      break; // leave it to zero-copy send
+    bufs.emplace_back(op->data() + op->offset_, op->size() - op->offset_);
+    bytes += op->size() - op->offset_;
+  }
+
+  int n = writev_cb_(bufs.data(), static_cast<int>(bufs.size()));
+  if (n > 0)
+  { // complete the ops which fully sent, remain data will be send at next frame.
+    for (size_t remain = n; remain > 0;)
+    {
+      op          = send_queue_.peek();
+      auto length = (std::min)(op->size() - op->offset_, remain);
+      op->offset_ += length;
+      remain -= length;
+      if (op->offset_ == op->size())
+        this->complete_op(op, 0);
+    }
+  }
+  else if (n < 0)
+  {
+    error = xxsocket::get_last_errno();
+    if (xxsocket::not_send_error(error))
+      n = 0;
+  }
+  return n;
+}
 void io_transport::complete_op(io_send_op* op, int error)
 {
-  YASIO_KLOGV("[index: %d] write complete, bytes transferred: %d/%d", this->cindex(), static_cast<int>(op->offset_), static_cast<int>(op->buffer_.size()));
+  YASIO_KLOGV("[index: %d] write complete, bytes transferred: %d/%d", this->cindex(), static_cast<int>(op->offset_), static_cast<int>(op->size()));
+  queued_bytes_ -= op->size();
   if (op->handler_)
     op->handler_(error, op->offset_);
   send_queue_.pop();
@@ -486,7 +625,133 @@ void io_transport::set_primitives()
   this->read_cb_  = [=](void* data, int len) { return socket_->recv(data, len, 0); };
 }
 // -------------------- io_transport_tcp ---------------------
-inline io_transport_tcp::io_transport_tcp(io_channel* ctx, std::shared_ptr<xxsocket>& s) : io_transport(ctx, s) {}
+inline io_transport_tcp::io_transport_tcp(io_channel* ctx, std::shared_ptr<xxsocket>& s) : io_transport(ctx, s)
+{
+  if (yasio__testbits(ctx->properties_, YCF_PACKET_VIEW))
+    reserve_chunk(YASIO_INET_BUFFER_SIZE, 0);
+#if defined(__linux__)
+  const int threshold = get_service().options_.zerocopy_threshold_;
+  if (threshold > 0 && !yasio__testbits(ctx->properties_, YCM_SSL) && socket_->set_optval(SOL_SOCKET, SO_ZEROCOPY, 1) == 0)
+    this->zerocopy_threshold_ = static_cast<size_t>(threshold);
+#endif
+}
+void io_transport_tcp::set_primitives()
+{
+  io_transport::set_primitives();
+  this->writev_cb_ = [=](const iobuf* bufs, int count) { return socket_->sendv(bufs, count); };
+#if YASIO__HAS_IO_URING
+  auto& watcher = get_service().io_watcher_;
+  auto fd       = socket_->native_handle();
+  if (watcher.enable_stream(fd))
+  { // receive & send by io_uring completions, the send op is referred by kernel until completed, zero-copy is needless
+    this->read_cb_            = [&watcher, fd](void* data, int len) { return watcher.recv(fd, data, len); };
+    this->writev_cb_          = [&watcher, fd](const iobuf* bufs, int count) { return watcher.sendv(fd, bufs, count); };
+    this->zerocopy_threshold_ = 0;
+  }
+#endif
+}
+#if defined(__linux__)
+bool io_transport_tcp::do_write(highp_time_t& wait_duration)
+{
+  if (!zerocopy_ops_.empty())
+    reap_zerocopy();
+  return io_transport::do_write(wait_duration);
+}
+int io_transport_tcp::call_writev(io_send_op* op, int& error)
+{
+  // the op which partial sent with MSG_ZEROCOPY must be completed by zero-copy send
+  if ((zerocopy_threshold_ && op->size() >= zerocopy_threshold_) || (!zerocopy_ops_.empty() && !zerocopy_ops_.back().op))
+    return call_zerocopy_write(op, error);
+  return io_transport::call_writev(op, error);
+}
+int io_transport_tcp::call_zerocopy_write(io_send_op* op, int& error)
+{
+  auto data     = op->data() + op->offset_;
+  int len       = static_cast<int>((std::min)(op->size() - op->offset_, static_cast<size_t>(INT_MAX)));
+  bool zerocopy = zerocopy_threshold_ != 0;
+  int n         = socket_->send(data, len, zerocopy ? MSG_ZEROCOPY : 0);
+  if (n < 0 && zerocopy && xxsocket::get_last_errno() == ENOBUFS)
+  { // exceed the optmem limit of socket, copy this time
+    zerocopy = false;
+    n        = socket_->send(data, len);
+  }
+  if (n > 0)
+  {
+    bool sending = !zerocopy_ops_.empty() && !zerocopy_ops_.back().op;
+    if (zerocopy)
+    {
+      if (!sending)
+        zerocopy_ops_.push_back(zerocopy_op{zerocopy_seq_, zerocopy_seq_, 0, nullptr});
+      auto& zop = zerocopy_ops_.back();
+      zop.last  = zerocopy_seq_++;
+      ++zop.pending;
+      sending = true;
+    }
+    op->offset_ += n;
+    if (op->offset_ == op->size())
+    {
+      if (sending)
+      { // the op will be completed when kernel release the pages
+        queued_bytes_ -= op->size();
+        zerocopy_ops_.back().op = send_queue_.take();
+      }
+      else
+        this->complete_op(op, 0);
+    }
+  }
+  else if (n < 0)
+  {
+    error = xxsocket::get_last_errno();
+    if (xxsocket::not_send_error(error))
+      n = 0;
+  }
+  return n;
+}
+void io_transport_tcp::reap_zerocopy()
+{
+  char control[CMSG_SPACE(sizeof(sock_extended_err)) * 4];
+  for (;;)
+  {
+    msghdr msg         = {};
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+    if (::recvmsg(socket_->native_handle(), &msg, MSG_ERRQUEUE) < 0)
+      break; // EAGAIN: no more notifications
+    for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+      if (!((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) || (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)))
+        continue;
+      sock_extended_err serr;
+      ::memcpy(&serr, CMSG_DATA(cmsg), sizeof(serr));
+      if (serr.ee_origin != SO_EE_ORIGIN_ZEROCOPY || serr.ee_errno != 0)
+        continue;
+      if ((serr.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) && zerocopy_threshold_)
+      { // the kernel copied data, such as loopback, zero-copy only adds the cost of notifications
+        YASIO_KLOGD("[index: %d] the kernel copied zero-copy data, stop zero-copy send", this->cindex());
+        zerocopy_threshold_ = 0;
+      }
+      // the notification is the range of send sequences released [ee_info, ee_data], the 32 bits
+      // sequences wrap around, so compare them by serial number arithmetic
+      auto seq_before = [](uint32_t lhs, uint32_t rhs) { return static_cast<int32_t>(lhs - rhs) < 0; };
+      for (auto& zop : zerocopy_ops_)
+      {
+        auto lo = seq_before(serr.ee_info, zop.first) ? zop.first : serr.ee_info;
+        auto hi = seq_before(zop.last, serr.ee_data) ? zop.last : serr.ee_data;
+        if (!seq_before(hi, lo))
+          zop.pending -= (hi - lo + 1);
+      }
+    }
+  }
+  while (!zerocopy_ops_.empty() && zerocopy_ops_.front().op && zerocopy_ops_.front().pending == 0)
+  {
+    auto op = std::move(zerocopy_ops_.front().op);
+    zerocopy_ops_.pop_front();
+    YASIO_KLOGV("[index: %d] zero-copy write complete, bytes transferred: %d", this->cindex(), static_cast<int>(op->offset_));
+    if (op->handler_)
+      op->handler_(0, op->offset_);
+  }
+}
+#endif
 // ----------------------- io_transport_ssl ----------------
 #if defined(YASIO_SSL_BACKEND)
 io_transport_ssl::io_transport_ssl(io_channel* ctx, std::shared_ptr<xxsocket>& s) : io_transport_tcp(ctx, s), ssl_(std::move(ctx->ssl_))
@@ -579,8 +844,27 @@ void io_transport_ssl::set_primitives()
 }
 #endif
 // ----------------------- io_transport_udp ----------------
-io_transport_udp::io_transport_udp(io_channel* ctx, std::shared_ptr<xxsocket>& s) : io_transport(ctx, s) {}
-io_transport_udp::~io_transport_udp() {}
+io_transport_udp::io_transport_udp(io_channel* ctx, std::shared_ptr<xxsocket>& s) : io_transport(ctx, s)
+{
+#if defined(__linux__)
+  if (yasio__testbits(ctx->properties_, YCF_UDP_GSO))
+  { // probe kernel support, the transport use normal io if not available
+    int gso_size = 0;
+    gso_         = socket_->get_optval(IPPROTO_UDP, UDP_SEGMENT, gso_size) == 0;
+    gro_         = socket_->set_optval(IPPROTO_UDP, UDP_GRO, 1) == 0;
+    YASIO_KLOGD("[index: %d] udp segmentation offload: gso=%d, gro=%d", this->cindex(), (int)gso_, (int)gro_);
+  }
+#endif
+}
+io_transport_udp::~io_transport_udp()
+{
+  if (this->shared_socket_)
+  { // remove from the demultiplexing map of server channel
+    auto it = ctx_->dgram_peers_.find(this->peer_);
+    if (it != ctx_->dgram_peers_.end() && it->second == this)
+      ctx_->dgram_peers_.erase(it);
+  }
+}
 ip::endpoint io_transport_udp::remote_endpoint() const { return !connected_ ? this->peer_ : socket_->peer_endpoint(); }
 const ip::endpoint& io_transport_udp::ensure_destination() const
 {
@@ -627,11 +911,20 @@ int io_transport_udp::write(std::vector<char>&& buffer, completion_cb_t&& handle
 {
   return connected_ ? io_transport::write(std::move(buffer), std::move(handler)) : write_to(std::move(buffer), ensure_destination(), std::move(handler));
 }
+int io_transport_udp::write_shared(const shared_buffer_t& buffer, completion_cb_t&& handler)
+{
+  if (connected_)
+    return io_transport::write_shared(buffer, std::move(handler));
+  int n = static_cast<int>(buffer->size());
+  send_queue_.emplace(cxx14::make_unique<io_sendto_op>(buffer, std::move(handler), ensure_destination()));
+  get_service().wakeup(this);
+  return n;
+}
 int io_transport_udp::write_to(std::vector<char>&& buffer, const ip::endpoint& to, completion_cb_t&& handler)
 {
   int n = static_cast<int>(buffer.size());
   send_queue_.emplace(cxx14::make_unique<io_sendto_op>(std::move(buffer), std::move(handler), to));
-  get_service().interrupt();
+  get_service().wakeup(this);
   return n;
 }
 void io_transport_udp::set_primitives()
@@ -660,6 +953,167 @@ void io_transport_udp::set_primitives()
     };
   }
 }
+int io_transport_udp::do_read(int revent, int& error, highp_time_t& wait_duration)
+{
+#if defined(__linux__)
+  if (recv_batch_enabled())
+  { // io_service::do_read will call again until all datagrams of the batch consumed.
+    auto& service = get_service();
+    auto& batch   = service.dgram_batch_;
+    if (batch.index_ == batch.count_)
+    {
+      if (!revent)
+        return 0;
+      int count = service.recv_dgram_batch(socket_.get(), error);
+      if (count <= 0)
+        return count;
+    }
+    auto& dgram = batch.dgrams_[batch.index_++];
+    int n       = dgram.size;
+    if (yasio__unlikely(n > YASIO_INET_BUFFER_SIZE - offset_))
+    { // drop the datagram which can't be stored completely, a truncated datagram will be decoded as corrupted frames
+      YASIO_KLOGE("[index: %d] the datagram size %d exceeds recv buffer space %d, dropped", this->cindex(), n, YASIO_INET_BUFFER_SIZE - offset_);
+      return 0;
+    }
+    ::memcpy(buffer_ + offset_, dgram.data, n);
+    if (!connected_)
+      this->peer_ = batch.peers_[dgram.peer];
+    ctx_->bytes_transferred_ += n;
+    return n;
+  }
+#endif
+  return io_transport::do_read(revent, error, wait_duration);
+}
+bool io_transport_udp::recv_batch_enabled() const { return gro_ || get_service().options_.udp_recv_batch_ > 1; }
+int io_transport_udp::call_writev(io_send_op* op, int& error)
+{
+#if defined(__linux__)
+  if (gso_ && send_queue_.next(op) != nullptr)
+  {
+    int n = call_gso_write(op, error);
+    if (n >= 0)
+      return n;
+  }
+  auto& service   = get_service();
+  const int batch = service.options_.udp_send_batch_;
+  if (batch > 1 && send_queue_.next(op) != nullptr)
+  {
+    auto& bufs = service.iobufs_;
+    auto& hdrs = service.dgram_batch_.send_hdrs_;
+    bufs.clear();
+    hdrs.clear();
+    for (; op != nullptr && static_cast<int>(bufs.size()) < batch; op = send_queue_.next(op))
+    {
+      bufs.emplace_back(op->data() + op->offset_, op->size() - op->offset_);
+      mmsghdr hdr{};
+      if (!connected_)
+      {
+        auto destination        = op->destination() ? op->destination() : &ensure_destination();
+        hdr.msg_hdr.msg_name    = (void*)&destination->sa_;
+        hdr.msg_hdr.msg_namelen = destination->len();
+      }
+      hdrs.push_back(hdr);
+    }
+    for (size_t i = 0; i < hdrs.size(); ++i)
+    { // the bufs is stable now
+      hdrs[i].msg_hdr.msg_iov    = &bufs[i];
+      hdrs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int count = ::sendmmsg(socket_->native_handle(), hdrs.data(), static_cast<unsigned int>(hdrs.size()), 0);
+    if (count > 0)
+    {
+      int bytes_transferred = 0;
+      for (int i = 0; i < count; ++i)
+      { // the datagram always sent completely
+        op          = send_queue_.peek();
+        op->offset_ = op->size();
+        bytes_transferred += static_cast<int>(op->offset_);
+        this->complete_op(op, 0);
+      }
+      return bytes_transferred;
+    }
+    error = xxsocket::get_last_errno();
+    if (!xxsocket::not_send_error(error))
+    { // same as call_write, simply drop the op which can't be sent
+      YASIO_KLOGI("[index: %d] sendmmsg failed, ec=%d, detail:%s", this->cindex(), error, io_service::strerror(error));
+      this->complete_op(send_queue_.peek(), error);
+    }
+    return 0;
+  }
+#endif
+  return io_transport::call_writev(op, error);
+}
+#if defined(__linux__)
+int io_transport_udp::call_gso_write(io_send_op* op, int& error)
+{
+  // the segment size is the first datagram size, only the last one can be shorter
+  const size_t gso_size = op->size() - op->offset_;
+  if (gso_size == 0) // the empty datagram can't be a segment, send it normally
+    return -1;
+  auto destination      = connected_ ? nullptr : (op->destination() ? op->destination() : &ensure_destination());
+  auto& bufs            = get_service().iobufs_;
+  bufs.clear();
+  for (size_t bytes = 0; op != nullptr && bufs.size() < yasio__udp_gso_max_segments; op = send_queue_.next(op))
+  {
+    const size_t size = op->size() - op->offset_;
+    if (size == 0 || size > gso_size || bytes + size > yasio__udp_gso_max_bytes)
+      break;
+    if (destination && op->destination() && op->destination() != destination && !ip::endpoint_equal_to{}(*op->destination(), *destination))
+      break;
+    bufs.emplace_back(op->data() + op->offset_, size);
+    bytes += size;
+    if (size < gso_size)
+      break;
+  }
+  if (bufs.size() < 2)
+    return -1;
+
+  msghdr msg{};
+  char control[CMSG_SPACE(sizeof(uint16_t))] = {};
+  if (destination)
+  {
+    msg.msg_name    = (void*)&destination->sa_;
+    msg.msg_namelen = destination->len();
+  }
+  msg.msg_iov        = static_cast<iovec*>(bufs.data());
+  msg.msg_iovlen     = bufs.size();
+  msg.msg_control    = control;
+  msg.msg_controllen = sizeof(control);
+  auto cmsg          = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level   = IPPROTO_UDP;
+  cmsg->cmsg_type    = UDP_SEGMENT;
+  cmsg->cmsg_len     = CMSG_LEN(sizeof(uint16_t));
+  const uint16_t segment_size = static_cast<uint16_t>(gso_size);
+  ::memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+
+  int n = static_cast<int>(::sendmsg(socket_->native_handle(), &msg, 0));
+  if (n > 0)
+  { // the kernel split the payload to datagrams, all of them sent completely
+    for (size_t i = 0; i < bufs.size(); ++i)
+    {
+      op          = send_queue_.peek();
+      op->offset_ = op->size();
+      this->complete_op(op, 0);
+    }
+    return n;
+  }
+  error = xxsocket::get_last_errno();
+  if (xxsocket::not_send_error(error))
+    return 0;
+  if (error == EIO || error == EINVAL || error == ENOPROTOOPT || error == EOPNOTSUPP)
+  { // the kernel or device reject segmentation offload, such as segment size exceeds mtu
+    YASIO_KLOGI("[index: %d] udp gso unavailable, ec=%d, detail:%s, fallback to normal send", this->cindex(), error, io_service::strerror(error));
+    gso_  = false;
+    error = 0;
+    return -1;
+  }
+  // same as call_write, simply drop the op which can't be sent
+  YASIO_KLOGI("[index: %d] sendmsg failed, ec=%d, detail:%s", this->cindex(), error, io_service::strerror(error));
+  this->complete_op(send_queue_.peek(), error);
+  return 0;
+}
+#endif
 int io_transport_udp::handle_input(const char* buf, int bytes_transferred, int& /*error*/, highp_time_t&)
 { // pure udp, dispatch to upper layer directly
   get_service().handle_event(cxx14::make_unique<io_event>(this->cindex(), io_packet{buf, buf + bytes_transferred}, this));
@@ -671,14 +1125,24 @@ int io_transport_udp::handle_input(const char* buf, int bytes_transferred, int&
 io_transport_kcp::io_transport_kcp(io_channel* ctx, std::shared_ptr<xxsocket>& s) : io_transport_udp(ctx, s)
 {
   this->kcp_ = ::ikcp_create(static_cast<IUINT32>(ctx->kcp_conv_), this);
+#if !defined(YASIO_ENABLE_SHARED_RECV_BUFFER)
   this->rawbuf_.resize(YASIO_INET_BUFFER_SIZE);
+#endif
   ::ikcp_nodelay(this->kcp_, 1, 5000 /*kcp max interval is 5000(ms)*/, 2, 1);
   ::ikcp_setoutput(this->kcp_, [](const char* buf, int len, ::ikcpcb* /*kcp*/, void* user) {
     auto t = (io_transport_kcp*)user;
-    if (yasio__min_wait_duration == 0)
+    if (yasio__min_wait_duration == 0 && !t->gso_)
       return t->write_cb_(buf, len, &t->ensure_destination());
-    // Enqueue to transport queue
-    return t->io_transport_udp::write(std::vector<char>(buf, buf + len), nullptr);
+    // Enqueue to transport queue, the segments of one flush can be sent by gso at once.
+    // The output always called at io_service thread before do_write drains the queue,
+    // so needn't wakeup or interrupt io_service
+    std::vector<char> buffer(buf, buf + len);
+    t->queued_bytes_ += len;
+    if (t->connected_)
+      t->send_queue_.emplace(cxx14::make_unique<io_send_op>(std::move(buffer), nullptr));
+    else
+      t->send_queue_.emplace(cxx14::make_unique<io_sendto_op>(std::move(buffer), nullptr, t->ensure_destination()));
+    return len;
   });
 }
 io_transport_kcp::~io_transport_kcp() { ::ikcp_release(this->kcp_); }
@@ -688,17 +1152,56 @@ int io_transport_kcp::write(std::vector<char>&& buffer, completion_cb_t&& /*hand
   std::lock_guard<std::recursive_mutex> lck(send_mtx_);
   int len    = static_cast<int>(buffer.size());
   int retval = ::ikcp_send(kcp_, buffer.data(), len);
-  get_service().interrupt();
+  get_service().wakeup(this);
+  return retval == 0 ? len : retval;
+}
+int io_transport_kcp::write_shared(const shared_buffer_t& buffer, completion_cb_t&& /*handler*/)
+{ // kcp copy data to its segments always
+  std::lock_guard<std::recursive_mutex> lck(send_mtx_);
+  int len    = static_cast<int>(buffer->size());
+  int retval = ::ikcp_send(kcp_, buffer->data(), len);
+  get_service().wakeup(this);
   return retval == 0 ? len : retval;
 }
 int io_transport_kcp::do_read(int revent, int& error, highp_time_t& wait_duration)
 {
-  int n = revent ? this->call_read(&rawbuf_.front(), static_cast<int>(rawbuf_.size()), error) : 0;
-  if (n > 0)
-    this->handle_input(rawbuf_.data(), n, error, wait_duration);
+  int n = 0;
+#if defined(__linux__)
+  if (recv_batch_enabled())
+  {
+    if (revent)
+    {
+      auto& batch = get_service().dgram_batch_;
+      int count   = get_service().recv_dgram_batch(socket_.get(), error);
+      for (int i = 0; i < count; ++i)
+      {
+        auto& dgram = batch.dgrams_[i];
+        if (!connected_)
+          this->peer_ = batch.peers_[dgram.peer];
+        ctx_->bytes_transferred_ += dgram.size;
+        if (this->handle_input(dgram.data, dgram.size, error, wait_duration) < 0)
+          break;
+      }
+      batch.count_ = batch.index_ = 0;
+      if (count < 0)
+        return count;
+    }
+  }
+  else
+#endif
+  {
+#if !defined(YASIO_ENABLE_SHARED_RECV_BUFFER)
+    char* rawbuf = &rawbuf_.front();
+#else
+    char* rawbuf = buffer_ + YASIO_INET_BUFFER_SIZE;
+#endif
+    n = revent ? this->call_read(rawbuf, YASIO_INET_BUFFER_SIZE, error) : 0;
+    if (n > 0)
+      this->handle_input(rawbuf, n, error, wait_duration);
+  }
   if (!error)
   { // !important, should always try to call ikcp_recv when no error occured.
-    n = ::ikcp_recv(kcp_, buffer_ + offset_, sizeof(buffer_) - offset_);
+    n = ::ikcp_recv(kcp_, buffer_ + offset_, YASIO_INET_BUFFER_SIZE - offset_);
     if (n > 0) // If got data from kcp, don't wait
       wait_duration = yasio__min_wait_duration;
     else if (n < 0)
@@ -726,7 +1229,7 @@ bool io_transport_kcp::do_write(highp_time_t& wait_duration)
   ::ikcp_update(kcp_, static_cast<IUINT32>(::yasio::clock()));
   ::ikcp_flush(kcp_);
   this->check_timeout(wait_duration); // call ikcp_check
-  if (yasio__min_wait_duration == 0)
+  if (yasio__min_wait_duration == 0 && !gso_)
     return true;
   // Call super do_write to perform low layer socket.send
   // benefit of transport queue:
@@ -823,17 +1326,16 @@ void io_service::init(const io_hostent* channel_eps, int channel_count)
   if (channel_count < 1)
     channel_count = 1;
 
-  FD_ZERO(&fds_array_[read_op]);
-  FD_ZERO(&fds_array_[write_op]);
-  FD_ZERO(&fds_array_[except_op]);
-
-  this->max_nfds_  = 0;
   options_.resolv_ = [=](std::vector<ip::endpoint>& eps, const char* host, unsigned short port) { return this->resolve(eps, host, port); };
   register_descriptor(interrupter_.read_descriptor(), YEM_POLLIN);
 
   // Create channels
   create_channels(channel_eps, channel_count);
 
+#if defined(YASIO_ENABLE_SHARED_RECV_BUFFER)
+  recv_buffer_.resize(YASIO_INET_BUFFER_SIZE * 2);
+#endif
+
 #if !defined(YASIO_HAVE_CARES)
   life_mutex_ = std::make_shared<cxx17::shared_mutex>();
   life_token_ = std::make_shared<life_token>();
@@ -851,7 +1353,7 @@ void io_service::cleanup()
 
     clear_channels();
     this->events_.clear();
-    this->timer_queue_.clear();
+    this->timer_wheel_.clear([](wheel_node* node) { timer_cb_t{std::move(static_cast<highp_timer*>(node)->cb_)}; });
 
     unregister_descriptor(interrupter_.read_descriptor(), YEM_POLLIN);
 
@@ -879,16 +1381,126 @@ void io_service::create_channels(const io_hostent* channel_eps, int channel_coun
 void io_service::clear_channels()
 {
   this->channel_ops_.clear();
+  std::lock_guard<std::recursive_mutex> lck(this->channels_mtx_);
+  for (auto channel : removed_channels_)
+    channels_.push_back(channel);
   for (auto channel : channels_)
   {
+    if (!channel)
+      continue;
     channel->timer_.cancel(*this);
     cleanup_io(channel);
     delete channel;
   }
   channels_.clear();
+  free_slots_.clear();
+  removed_channels_.clear();
+}
+int io_service::add_channel(const io_hostent* ep)
+{
+  std::lock_guard<std::recursive_mutex> lck(this->channels_mtx_);
+  int index;
+  if (!free_slots_.empty())
+  {
+    index = free_slots_.back();
+    free_slots_.pop_back();
+  }
+  else
+  {
+    index = static_cast<int>(channels_.size());
+    channels_.push_back(nullptr);
+  }
+  auto channel = new io_channel(*this, index);
+  if (ep != nullptr)
+    channel->set_address(ep->host_, ep->port_);
+  channels_[index] = channel;
+  return index;
+}
+int io_service::remove_channel(int index)
+{
+  {
+    std::lock_guard<std::recursive_mutex> lck(this->channels_mtx_);
+    if (index < 0 || index >= static_cast<int>(channels_.size()) || !channels_[index])
+      return -1;
+    removed_channels_.push_back(channels_[index]);
+    channels_[index] = nullptr;
+  }
+  this->reap_channels_ = true;
+  this->interrupt();
+  return 0;
+}
+void io_service::process_removed_channels()
+{
+  std::vector<io_channel*> channels;
+  std::vector<int> slots;
+  {
+    std::lock_guard<std::recursive_mutex> lck(this->channels_mtx_);
+    channels.swap(removed_channels_);
+  }
+  for (auto iter = channels.begin(); iter != channels.end();)
+  {
+    auto ctx = *iter;
+    if (try_release_channel(ctx))
+    { // the slot can be reused now
+      slots.push_back(ctx->index_);
+      delete ctx;
+      iter = channels.erase(iter);
+    }
+    else
+      ++iter;
+  }
+  std::lock_guard<std::recursive_mutex> lck(this->channels_mtx_);
+  free_slots_.insert(free_slots_.end(), slots.begin(), slots.end());
+  if (!channels.empty())
+  { // try again at next loop
+    removed_channels_.insert(removed_channels_.end(), channels.begin(), channels.end());
+    this->reap_channels_ = true;
+  }
+}
+bool io_service::try_release_channel(io_channel* ctx)
+{
+  yasio__clearbits(ctx->opmask_, YOPM_OPEN);
+  if (yasio__find_if(this->transports_, [ctx](const io_transport* transport) { return transport->ctx_ == ctx; }) != this->transports_.end())
+  { // the transports are closed by process_transports
+    yasio__setbits(ctx->opmask_, YOPM_CLOSE);
+    this->rescan_transports_ = true;
+    this->wait_duration_     = yasio__min_wait_duration;
+    return false;
+  }
+  if (ctx->dns_queries_state_ == YDQS_INPROGRESS)
+    return false; // the resolver will interrupt when done
+
+  this->channel_ops_mtx_.lock();
+  auto it = yasio__find(this->channel_ops_, ctx);
+  if (it != this->channel_ops_.end())
+    this->channel_ops_.erase(it);
+  this->channel_ops_mtx_.unlock();
+
+  ctx->timer_.cancel(*this);
+#if !defined(YASIO_NO_USER_TIMER)
+  ctx->user_timer_.cancel(*this);
+#endif
+  cleanup_io(ctx);
+#if !defined(YASIO_HAVE_CARES)
+  // wait the resolver thread which may still assign the resolved endpoints
+  std::unique_lock<cxx17::shared_mutex> lck(*life_mutex_);
+#endif
+  return true;
 }
 void io_service::clear_transports()
 {
+  std::unique_lock<std::recursive_mutex> lck(this->tslots_mtx_);
+  for (uint32_t slot = 0; slot < tslots_.size(); ++slot)
+  { // invalidate all keys before the transports destroyed, the slots are reused with next generation
+    if (tslots_[slot].transport)
+    {
+      tslots_[slot].transport = nullptr;
+      ++tslots_[slot].generation;
+      free_tslots_.push_back(slot);
+    }
+  }
+  lck.unlock();
+  std::lock_guard<std::recursive_mutex> wakeup_lck(this->wakeup_mtx_); // see deallocate_transport
   for (auto transport : transports_)
   {
     cleanup_io(transport);
@@ -896,6 +1508,9 @@ void io_service::clear_transports()
     this->tpool_.push_back(transport);
   }
   transports_.clear();
+  active_transports_.clear();
+  fd_transports_.clear();
+  wakeup_transports_.clear();
 }
 void io_service::dispatch(int max_count)
 {
@@ -917,30 +1532,36 @@ void io_service::run()
   this->ipsv_ = static_cast<u_short>(xxsocket::getipsv());
 
   // The core event loop
-  fd_set fds_array[max_ops];
   this->wait_duration_ = YASIO_MAX_WAIT_DURATION;
   for (; this->state_ == io_service::state::RUNNING;)
   {
+    this->now_           = highp_clock();
     auto wait_duration   = get_timeout(this->wait_duration_); // Gets current wait duration
     this->wait_duration_ = YASIO_MAX_WAIT_DURATION;           // Reset next wait duration
     if (wait_duration > 0)
     {
-      int retval = do_select(fds_array, wait_duration);
+      // Don't block when interrupted after last wait, the pending works must be processed first.
+      if (!interrupter_.prepare_wait())
+        wait_duration = 0;
+      int retval = do_evpoll(wait_duration);
+      interrupter_.finish_wait();
       if (this->state_ != io_service::state::RUNNING)
         break;
 
+      this->now_ = highp_clock();
+
       if (retval < 0)
       {
         int ec = xxsocket::get_last_errno();
-        YASIO_KLOGD("[core] do_select failed, ec=%d, detail:%s\n", ec, io_service::strerror(ec));
+        YASIO_KLOGD("[core] do_evpoll failed, ec=%d, detail:%s\n", ec, io_service::strerror(ec));
         if (ec != EBADF)
           continue; // Try again.
         goto _L_end;
       }
 
       if (retval == 0)
-        YASIO_KLOGV("[core] %s", "do_select is timeout, process_timers()");
-      else if (FD_ISSET(this->interrupter_.read_descriptor(), &(fds_array[read_op])))
+        YASIO_KLOGV("[core] %s", "do_evpoll is timeout, process_timers()");
+      else if (io_watcher_.is_ready(this->interrupter_.read_descriptor(), YEM_POLLIN))
       { // Reset the interrupter.
         if (!interrupter_.reset())
           interrupter_.recreate();
@@ -948,16 +1569,27 @@ void io_service::run()
       }
     }
 
+    // activate the transports which have readiness, keep the readiness of last poll when poll skipped
+    io_watcher_.for_each_ready([this](socket_native_type fd) {
+      auto it = fd_transports_.find(fd);
+      if (it != fd_transports_.end())
+        activate(it->second);
+    });
+
 #if defined(YASIO_HAVE_CARES)
     // process possible async resolve requests.
-    process_ares_requests(fds_array);
+    process_ares_requests();
 #endif
 
     // process active transports
-    process_transports(fds_array);
+    process_transports();
 
     // process active channels
-    process_channels(fds_array);
+    process_channels();
+
+    // destroy the channels removed by user
+    if (this->reap_channels_.exchange(false))
+      process_removed_channels();
 
     // process timeout timers
     process_timers();
@@ -972,29 +1604,72 @@ _L_end:
   cleanup_ssl_context();
 #endif
 }
-void io_service::process_transports(fd_set* fds_array)
+void io_service::process_transports()
 {
-  // preform transports
-  for (auto iter = transports_.begin(); iter != transports_.end();)
+  if (this->rescan_transports_.exchange(false))
+  {
+    for (auto transport : transports_)
+      activate(transport);
+  }
+
+  // the requests queued by other threads, the flags are set under the locks, swap out the queue to process without lock
+  if (this->broadcast_requested_.exchange(false))
+  {
+    decltype(broadcast_ops_) ops;
+    {
+      std::lock_guard<std::recursive_mutex> lck(this->broadcast_mtx_);
+      ops.swap(broadcast_ops_);
+    }
+    for (auto& item : ops)
+    { // the transports are woken up and processed below
+      for (auto transport : transports_)
+        if (transport->cindex() == item.first && transport->is_open() && reserve_write(transport, item.second->size()))
+          transport->write_shared(item.second, nullptr);
+    }
+  }
+
+  if (this->wakeup_requested_.exchange(false))
   {
-    auto transport = *iter;
-    bool ok        = (do_read(transport, fds_array) && do_write(transport));
+    {
+      std::lock_guard<std::recursive_mutex> lck(this->wakeup_mtx_);
+      std::swap(wakeup_transports_, processing_wakeups_);
+    }
+    for (auto key : processing_wakeups_)
+    { // the transport closed and slot reused after wakeup, drop the stale key
+      auto& item = tslots_[static_cast<uint32_t>(key)];
+      if (item.transport && item.generation == static_cast<uint32_t>(key >> 32))
+      {
+        item.transport->wakeup_pending_ = false;
+        activate(item.transport);
+      }
+    }
+    processing_wakeups_.clear();
+  }
+
+  // preform active transports only, the idle transports are not visited
+  std::swap(this->active_transports_, this->processing_transports_);
+  for (auto transport : processing_transports_)
+  {
+    transport->active_ = false;
+    bool ok            = (do_read(transport) && do_write(transport));
     if (ok)
     {
       int opm = transport->opmask_ | transport->ctx_->opmask_;
       if (0 == opm)
-      { // no open/close operations request
-        ++iter;
+      { // no open/close operations request, keep active when send ops pending without pollout or kcp need update
+        if ((!transport->send_queue_.empty() && !transport->pollout_registerred_) || yasio__testbits(transport->ctx_->properties_, YCM_KCP))
+          activate(transport);
         continue;
       }
       shutdown_internal(transport);
     }
 
+    remove_transport(transport);
     handle_close(transport);
-    iter = transports_.erase(iter);
   }
+  processing_transports_.clear();
 }
-void io_service::process_channels(fd_set* fds_array)
+void io_service::process_channels()
 {
   if (!this->channel_ops_.empty())
   {
@@ -1021,7 +1696,7 @@ void io_service::process_channels(fd_set* fds_array)
           }
         }
         else if (ctx->state_ == io_base::state::OPENING)
-          do_nonblocking_connect_completion(ctx, fds_array);
+          do_nonblocking_connect_completion(ctx);
 
         finish = ctx->error_ != EINPROGRESS && !yasio__testbits(ctx->opmask_, YOPM_OPEN);
       }
@@ -1035,7 +1710,7 @@ void io_service::process_channels(fd_set* fds_array)
 
         finish = (ctx->state_ != io_base::state::OPEN);
         if (!finish)
-          do_nonblocking_accept_completion(ctx, fds_array);
+          do_nonblocking_accept_completion(ctx);
         else
           ctx->bytes_transferred_ = 0;
       }
@@ -1060,16 +1735,19 @@ void io_service::close(int index)
     if (channel->socket_->is_open())
     {
       yasio__setbits(channel->opmask_, YOPM_CLOSE);
+      this->rescan_transports_ = true;
       this->interrupt();
     }
   }
 }
 void io_service::close(transport_handle_t transport)
 {
-  if (!yasio__testbits(transport->opmask_, YOPM_CLOSE))
+  // serialize with deallocate_transport, the handle of closed transport is ignored
+  std::lock_guard<std::recursive_mutex> lck(this->wakeup_mtx_);
+  if (transport->is_valid() && !yasio__testbits(transport->opmask_, YOPM_CLOSE))
   {
     yasio__setbits(transport->opmask_, YOPM_CLOSE);
-    this->interrupt();
+    this->wakeup(transport);
   }
 }
 bool io_service::is_open(transport_handle_t transport) const { return transport->is_open(); }
@@ -1094,7 +1772,11 @@ void io_service::open(size_t index, int kind)
     open_internal(ctx);
   }
 }
-io_channel* io_service::channel_at(size_t index) const { return (index < channels_.size()) ? channels_[index] : nullptr; }
+io_channel* io_service::channel_at(size_t index) const
+{
+  std::lock_guard<std::recursive_mutex> lck(this->channels_mtx_);
+  return (index < channels_.size()) ? channels_[index] : nullptr;
+}
 void io_service::handle_close(transport_handle_t thandle)
 {
   auto ctx = thandle->ctx_;
@@ -1116,50 +1798,126 @@ void io_service::handle_close(transport_handle_t thandle)
     ctx->properties_ &= 0xffffff; // clear highest byte flags
   }
 }
-void io_service::register_descriptor(const socket_native_type fd, int flags)
+void io_service::register_descriptor(const socket_native_type fd, int flags) { io_watcher_.mod_event(fd, flags, 0); }
+void io_service::unregister_descriptor(const socket_native_type fd, int flags) { io_watcher_.mod_event(fd, 0, flags); }
+int io_service::write(transport_handle_t transport, std::vector<char> buffer, completion_cb_t handler)
 {
-  if (yasio__testbits(flags, YEM_POLLIN))
-    FD_SET(fd, &(fds_array_[read_op]));
-
-  if (yasio__testbits(flags, YEM_POLLOUT))
-    FD_SET(fd, &(fds_array_[write_op]));
-
-  if (yasio__testbits(flags, YEM_POLLERR))
-    FD_SET(fd, &(fds_array_[except_op]));
-
-  if (max_nfds_ < static_cast<int>(fd) + 1)
-    max_nfds_ = static_cast<int>(fd) + 1;
+  if (transport && transport->is_open())
+  {
+    if (!reserve_write(transport, buffer.size()))
+      return -1;
+    return !buffer.empty() ? transport->write(std::move(buffer), std::move(handler)) : 0;
+  }
+  else
+  {
+    YASIO_KLOGE("[transport: %p] send failed, the connection not ok!", (void*)transport);
+    return -1;
+  }
 }
-void io_service::unregister_descriptor(const socket_native_type fd, int flags)
+int io_service::write(transport_handle_t transport, shared_buffer_t buffer, completion_cb_t handler)
 {
-  if (yasio__testbits(flags, YEM_POLLIN))
-    FD_CLR(fd, &(fds_array_[read_op]));
-
-  if (yasio__testbits(flags, YEM_POLLOUT))
-    FD_CLR(fd, &(fds_array_[write_op]));
-
-  if (yasio__testbits(flags, YEM_POLLERR))
-    FD_CLR(fd, &(fds_array_[except_op]));
+  if (transport && transport->is_open())
+  {
+    if (buffer && !reserve_write(transport, buffer->size()))
+      return -1;
+    return (buffer && !buffer->empty()) ? transport->write_shared(buffer, std::move(handler)) : 0;
+  }
+  else
+  {
+    YASIO_KLOGE("[transport: %p] send failed, the connection not ok!", (void*)transport);
+    return -1;
+  }
 }
-int io_service::write(transport_handle_t transport, std::vector<char> buffer, completion_cb_t handler)
+int io_service::write(transport_key_t key, std::vector<char> buffer, completion_cb_t handler)
+{
+  // hold the lock until enqueued, the transport can't be closed and reused meanwhile
+  std::lock_guard<std::recursive_mutex> lck(this->tslots_mtx_);
+  auto slot = static_cast<uint32_t>(key);
+  if (slot < tslots_.size() && tslots_[slot].generation == static_cast<uint32_t>(key >> 32) && tslots_[slot].transport)
+    return write(tslots_[slot].transport, std::move(buffer), std::move(handler));
+  YASIO_KLOGE("[transport: %llu] send failed, the connection not ok!", static_cast<unsigned long long>(key));
+  return -1;
+}
+int io_service::write(transport_key_t key, shared_buffer_t buffer, completion_cb_t handler)
+{
+  std::lock_guard<std::recursive_mutex> lck(this->tslots_mtx_);
+  auto slot = static_cast<uint32_t>(key);
+  if (slot < tslots_.size() && tslots_[slot].generation == static_cast<uint32_t>(key >> 32) && tslots_[slot].transport)
+    return write(tslots_[slot].transport, std::move(buffer), std::move(handler));
+  YASIO_KLOGE("[transport: %llu] send failed, the connection not ok!", static_cast<unsigned long long>(key));
+  return -1;
+}
+int io_service::broadcast(int cindex, shared_buffer_t buffer)
+{
+  if (!channel_at(cindex))
+    return -1;
+  if (!buffer || buffer->empty())
+    return 0;
+  int n = static_cast<int>(buffer->size());
+  {
+    std::lock_guard<std::recursive_mutex> lck(this->broadcast_mtx_);
+    broadcast_ops_.emplace_back(cindex, std::move(buffer));
+    broadcast_requested_ = true;
+  }
+  this->interrupt();
+  return n;
+}
+int io_service::write_to(transport_handle_t transport, std::vector<char> buffer, const ip::endpoint& to, completion_cb_t handler)
 {
   if (transport && transport->is_open())
-    return !buffer.empty() ? transport->write(std::move(buffer), std::move(handler)) : 0;
+  {
+    if (!reserve_write(transport, buffer.size()))
+      return -1;
+    return !buffer.empty() ? transport->write_to(std::move(buffer), to, std::move(handler)) : 0;
+  }
   else
   {
     YASIO_KLOGE("[transport: %p] send failed, the connection not ok!", (void*)transport);
     return -1;
   }
 }
-int io_service::write_to(transport_handle_t transport, std::vector<char> buffer, const ip::endpoint& to, completion_cb_t handler)
+bool io_service::do_write(transport_handle_t transport)
+{
+  if (!transport->do_write(this->wait_duration_))
+    return false;
+  auto& wparams = transport->ctx_->wparams_;
+  if (wparams.high_watermark > 0)
+  {
+    auto queued = transport->queued_bytes_.load();
+    if (!transport->write_blocked_ ? queued >= static_cast<size_t>(wparams.high_watermark) : queued <= static_cast<size_t>(wparams.low_watermark))
+    {
+      transport->write_blocked_ = !transport->write_blocked_;
+      handle_event(cxx14::make_unique<io_event>(transport->cindex(), transport->write_blocked_ ? YEK_ON_WRITE_BLOCKED : YEK_ON_WRITE_DRAINED,
+                                                static_cast<int>((std::min)(queued, static_cast<size_t>(INT_MAX))), transport));
+    }
+  }
+  return true;
+}
+bool io_service::reserve_write(transport_handle_t transport, size_t size)
 {
-  if (transport && transport->is_open())
-    return !buffer.empty() ? transport->write_to(std::move(buffer), to, std::move(handler)) : 0;
-  else
+  if (yasio__testbits(transport->ctx_->properties_, YCM_KCP))
+    return true; // kcp copies data to its own send queue, the output segments are counted when enqueued
+  auto& wparams = transport->ctx_->wparams_;
+  // count before enqueue, the op may be sent by io_service immediately
+  if (wparams.limit <= 0)
   {
-    YASIO_KLOGE("[transport: %p] send failed, the connection not ok!", (void*)transport);
-    return -1;
+    transport->queued_bytes_ += size;
+    return true;
   }
+  // the concurrent writers can't exceed the limit: reserve by CAS, nothing to rollback when rejected
+  auto queued = transport->queued_bytes_.load();
+  do
+  {
+    if (queued + size > static_cast<size_t>(wparams.limit))
+    {
+      YASIO_KLOGI("[index: %d] the send queue of connection #%u exceeds limit %d, queued bytes: %u", transport->cindex(), transport->id_, wparams.limit,
+                  static_cast<unsigned int>(queued));
+      if (wparams.policy == YWLP_CLOSE)
+        close(transport);
+      return false;
+    }
+  } while (!transport->queued_bytes_.compare_exchange_weak(queued, queued + size));
+  return true;
 }
 void io_service::handle_event(event_ptr event)
 {
@@ -1245,14 +2003,14 @@ void io_service::do_nonblocking_connect(io_channel* ctx)
     this->handle_connect_failed(ctx, xxsocket::get_last_errno());
 }
 
-void io_service::do_nonblocking_connect_completion(io_channel* ctx, fd_set* fds_array)
+void io_service::do_nonblocking_connect_completion(io_channel* ctx)
 {
   assert(ctx->state_ == io_base::state::OPENING && yasio__testbits(ctx->properties_, YCM_TCP) && yasio__testbits(ctx->properties_, YCM_CLIENT));
   if (ctx->state_ == io_base::state::OPENING)
   {
 #if !defined(YASIO_SSL_BACKEND)
     int error = -1;
-    if (FD_ISSET(ctx->socket_->native_handle(), &fds_array[write_op]) || FD_ISSET(ctx->socket_->native_handle(), &fds_array[read_op]))
+    if (io_watcher_.is_ready(ctx->socket_->native_handle(), YEM_POLLIN | YEM_POLLOUT))
     {
       if (ctx->socket_->get_optval(SOL_SOCKET, SO_ERROR, error) >= 0 && error == 0)
       {
@@ -1269,7 +2027,7 @@ void io_service::do_nonblocking_connect_completion(io_channel* ctx, fd_set* fds_
     if (!yasio__testbits(ctx->properties_, YCPF_SSL_HANDSHAKING))
     {
       int error = -1;
-      if (FD_ISSET(ctx->socket_->native_handle(), &fds_array[write_op]) || FD_ISSET(ctx->socket_->native_handle(), &fds_array[read_op]))
+      if (io_watcher_.is_ready(ctx->socket_->native_handle(), YEM_POLLIN | YEM_POLLOUT))
       {
         if (ctx->socket_->get_optval(SOL_SOCKET, SO_ERROR, error) >= 0 && error == 0)
         {
@@ -1489,24 +2247,35 @@ void io_service::ares_getaddrinfo_cb(void* arg, int status, int timeouts, ares_a
 
   current_service.interrupt();
 }
-void io_service::process_ares_requests(fd_set* fds_array)
+void io_service::register_ares_descriptors()
 {
-  if (this->ares_outstanding_work_ > 0)
-  {
-    ares_socket_t socks[ARES_GETSOCK_MAXNUM] = {0};
-    int bitmask                              = ::ares_getsock(this->ares_, socks, ARES_GETSOCK_MAXNUM);
+  ares_socket_t socks[ARES_GETSOCK_MAXNUM] = {0};
+  int bitmask                              = ::ares_getsock(this->ares_, socks, ARES_GETSOCK_MAXNUM);
 
-    for (int i = 0; i < ARES_GETSOCK_MAXNUM; ++i)
-    {
-      if (ARES_GETSOCK_READABLE(bitmask, i) || ARES_GETSOCK_WRITABLE(bitmask, i))
-      {
-        auto fd = socks[i];
-        ::ares_process_fd(this->ares_, FD_ISSET(fd, &(fds_array[read_op])) ? fd : ARES_SOCKET_BAD, FD_ISSET(fd, &(fds_array[write_op])) ? fd : ARES_SOCKET_BAD);
-      }
-      else
-        break;
-    }
+  for (int i = 0; i < ARES_GETSOCK_MAXNUM; ++i)
+  {
+    int flags = 0;
+    if (ARES_GETSOCK_READABLE(bitmask, i))
+      flags |= YEM_POLLIN;
+    if (ARES_GETSOCK_WRITABLE(bitmask, i))
+      flags |= YEM_POLLOUT;
+    if (!flags)
+      break;
+    register_descriptor(socks[i], flags);
+    this->ares_fds_.emplace_back(socks[i], flags);
+  }
+}
+void io_service::process_ares_requests()
+{
+  for (auto& item : this->ares_fds_)
+  {
+    auto fd = item.first;
+    ::ares_process_fd(this->ares_, io_watcher_.is_ready(fd, YEM_POLLIN) ? fd : ARES_SOCKET_BAD, io_watcher_.is_ready(fd, YEM_POLLOUT) ? fd : ARES_SOCKET_BAD);
   }
+  // the c-ares sockets may be closed or changed after process, so always unregister them
+  for (auto& item : this->ares_fds_)
+    unregister_descriptor(item.first, item.second);
+  this->ares_fds_.clear();
 }
 void io_service::recreate_ares_channel()
 {
@@ -1593,13 +2362,17 @@ void io_service::do_nonblocking_accept(io_channel* ctx)
       ctx->socket_->reuse_address(true);
     if (yasio__testbits(ctx->properties_, YCF_EXCLUSIVEADDRUSE))
       ctx->socket_->exclusive_address(false);
+#if defined(__linux__)
+    if (yasio__testbits(ctx->properties_, YCM_UDP) && yasio__testbits(ctx->properties_, YCF_UDP_GSO))
+      ctx->socket_->set_optval(IPPROTO_UDP, UDP_GRO, 1); // the datagrams not coalesced if failed
+#endif
     if (ctx->socket_->bind(ep) != 0)
     {
       where = io_base::error_stage::BIND_SOCKET;
       break;
     }
 
-    if (yasio__testbits(ctx->properties_, YCM_TCP) && ctx->socket_->listen(YASIO_SOMAXCONN) != 0)
+    if (yasio__testbits(ctx->properties_, YCM_TCP) && ctx->socket_->listen(ctx->backlog_) != 0)
     {
       where = io_base::error_stage::LISTEN_SOCKET;
       break;
@@ -1614,6 +2387,10 @@ void io_service::do_nonblocking_accept(io_channel* ctx)
       ctx->buffer_.resize(YASIO_INET_BUFFER_SIZE);
     }
     register_descriptor(ctx->socket_->native_handle(), YEM_POLLIN);
+#if YASIO__HAS_IO_URING
+    if (yasio__testbits(ctx->properties_, YCM_TCP))
+      io_watcher_.enable_acceptor(ctx->socket_->native_handle());
+#endif
     YASIO_KLOGD("[index: %d] open server succeed, socket.fd=%d listening at %s...", ctx->index_, (int)ctx->socket_->native_handle(), ep.to_string().c_str());
     error = 0;
   } while (false);
@@ -1629,61 +2406,63 @@ void io_service::do_nonblocking_accept(io_channel* ctx)
   handle_event(cxx14::make_unique<io_event>(ctx->index_, YEK_ON_OPEN, error, ctx, 1));
 #endif
 }
-void io_service::do_nonblocking_accept_completion(io_channel* ctx, fd_set* fds_array)
+void io_service::do_nonblocking_accept_completion(io_channel* ctx)
 {
   if (ctx->state_ == io_base::state::OPEN)
   {
     int error = 0;
-    if (FD_ISSET(ctx->socket_->native_handle(), &fds_array[read_op]) && ctx->socket_->get_optval(SOL_SOCKET, SO_ERROR, error) >= 0 && error == 0)
+    if (io_watcher_.is_ready(ctx->socket_->native_handle(), YEM_POLLIN) && ctx->socket_->get_optval(SOL_SOCKET, SO_ERROR, error) >= 0 && error == 0)
     {
       if (yasio__testbits(ctx->properties_, YCM_TCP))
-      {
+      { // accept until EAGAIN or budget exhausted
         socket_native_type sockfd{invalid_socket};
-        error = ctx->socket_->accept_n(sockfd);
-        if (error == 0)
+        int budget = options_.accept_budget_;
+        for (; budget > 0 && ctx->state_ == io_base::state::OPEN; --budget)
+        {
+#if YASIO__HAS_IO_URING
+          // take the connection accepted by io_uring multishot accept
+          error = io_watcher_.accept(ctx->socket_->native_handle(), sockfd);
+          if (error == -1)
+            error = ctx->socket_->accept_n(sockfd);
+#else
+          error = ctx->socket_->accept_n(sockfd);
+#endif
+          if (error != 0)
+            break;
           handle_connect_succeed(ctx, std::make_shared<xxsocket>(sockfd));
-        else // The non-blocking tcp accept failed can be ignored.
+        }
+        if (budget == 0) // the remain connections in queue are accepted at next iteration without wait
+          this->wait_duration_ = yasio__min_wait_duration;
+        else if (error != 0 && !xxsocket::not_recv_error(error)) // The non-blocking tcp accept failed can be ignored.
           YASIO_KLOGV("[index: %d] socket.fd=%d, accept failed, ec=%u", ctx->index_, (int)ctx->socket_->native_handle(), error);
       }
       else // YCM_UDP
       {
-        ip::endpoint peer;
-        int n = ctx->socket_->recvfrom(&ctx->buffer_.front(), static_cast<int>(ctx->buffer_.size()), peer);
-        if (n > 0)
+#if defined(__linux__)
+        if (options_.udp_recv_batch_ > 1 || yasio__testbits(ctx->properties_, YCF_UDP_GSO))
         {
-          YASIO_KLOGV("[index: %d] recvfrom peer: %s succeed.", ctx->index_, peer.to_string().c_str());
-#if !defined(_WIN32)
-          auto transport = static_cast<io_transport_udp*>(do_dgram_accept(ctx, peer, error));
-#else
-          /*
-           Because Bind() the client socket to the socket address of the listening socket.  On
-           Linux this essentially passes the responsibility for receiving data for the client
-           session from the well-known listening socket, to the newly allocated client socket.  It
-           is important to note that this behavior is not the same on other platforms, like
-           Windows (unfortunately), detail see:
-           https://blog.grijjy.com/2018/08/29/creating-high-performance-udp-servers-on-windows-and-linux
-           https://cloud.tencent.com/developer/article/1004555
-           So we emulate thus by ourself, don't care the performance, just a workaround implementation.
-         */
-          // for win32, we check exists udp clients by ourself, and only write operation can be
-          // perform on transports, the read operation still dispatch by channel.
-          auto it        = yasio__find_if(this->transports_, [&peer](const io_transport* transport) {
-            using namespace std;
-            return yasio__testbits(transport->ctx_->properties_, YCM_UDP) && static_cast<const io_transport_udp*>(transport)->remote_endpoint() == peer;
-          });
-          auto transport = static_cast<io_transport_udp*>(it != this->transports_.end() ? *it : do_dgram_accept(ctx, peer, error));
-#endif
-          if (transport)
-          {
-            if (transport->handle_input(ctx->buffer_.data(), n, error, this->wait_duration_) < 0)
-            {
-              transport->error_ = error;
-              close(transport);
-            }
+          auto& batch = this->dgram_batch_;
+          int count   = recv_dgram_batch(ctx->socket_.get(), error);
+          for (int i = 0; i < count; ++i)
+          { // the datagrams from the same peer in one batch are queued before the peer transport created
+            auto& dgram                  = batch.dgrams_[i];
+            transport_handle_t transport = nullptr;
+            for (int j = 0; j < i && !transport; ++j)
+              if (ip::endpoint_equal_to{}(batch.peers_[batch.dgrams_[j].peer], batch.peers_[dgram.peer]) && batch.transports_[j] &&
+                  batch.transports_[j]->is_valid())
+                transport = batch.transports_[j];
+            batch.transports_[i] = handle_dgram(ctx, batch.peers_[dgram.peer], dgram.data, dgram.size, transport);
           }
-          else
-            YASIO_KLOGE("[index: %d] do_dgram_accept failed, ec=%d, detail:%s", ctx->index_, error, this->strerror(error));
+          batch.count_ = batch.index_ = 0;
+          if (count < 0)
+            YASIO_KLOGE("[index: %d] recvmmsg failed, ec=%d, detail:%s", ctx->index_, error, this->strerror(error));
+          return;
         }
+#endif
+        ip::endpoint peer;
+        int n = ctx->socket_->recvfrom(&ctx->buffer_.front(), static_cast<int>(ctx->buffer_.size()), peer);
+        if (n > 0)
+          handle_dgram(ctx, peer, ctx->buffer_.data(), n, nullptr);
         else if (n < 0)
         {
           error = xxsocket::get_last_errno();
@@ -1694,8 +2473,138 @@ void io_service::do_nonblocking_accept_completion(io_channel* ctx, fd_set* fds_a
     }
   }
 }
+transport_handle_t io_service::handle_dgram(io_channel* ctx, const ip::endpoint& peer, const char* data, int n, transport_handle_t transport)
+{
+  YASIO_KLOGV("[index: %d] recvfrom peer: %s succeed.", ctx->index_, peer.to_string().c_str());
+  int error = 0;
+  if (!transport && yasio__testbits(ctx->properties_, YCF_UDP_SHARED_SOCKET))
+  {
+    auto it   = ctx->dgram_peers_.find(peer);
+    transport = it != ctx->dgram_peers_.end() ? it->second : do_dgram_accept(ctx, peer, error);
+  }
+  else if (!transport)
+  {
+#if !defined(_WIN32)
+    transport = do_dgram_accept(ctx, peer, error);
+#else
+    /*
+     Because Bind() the client socket to the socket address of the listening socket.  On
+     Linux this essentially passes the responsibility for receiving data for the client
+     session from the well-known listening socket, to the newly allocated client socket.  It
+     is important to note that this behavior is not the same on other platforms, like
+     Windows (unfortunately), detail see:
+     https://blog.grijjy.com/2018/08/29/creating-high-performance-udp-servers-on-windows-and-linux
+     https://cloud.tencent.com/developer/article/1004555
+     So we emulate thus by ourself, don't care the performance, just a workaround implementation.
+   */
+    // for win32, we check exists udp clients by ourself, and only write operation can be
+    // perform on transports, the read operation still dispatch by channel.
+    auto it   = yasio__find_if(this->transports_, [&peer](const io_transport* transport) {
+      using namespace std;
+      return yasio__testbits(transport->ctx_->properties_, YCM_UDP) && static_cast<const io_transport_udp*>(transport)->remote_endpoint() == peer;
+    });
+    transport = it != this->transports_.end() ? *it : do_dgram_accept(ctx, peer, error);
+#endif
+  }
+  if (transport)
+  {
+    if (static_cast<io_transport_udp*>(transport)->handle_input(data, n, error, this->wait_duration_) < 0)
+    {
+      transport->error_ = error;
+      close(transport);
+    }
+  }
+  else
+    YASIO_KLOGE("[index: %d] do_dgram_accept failed, ec=%d, detail:%s", ctx->index_, error, this->strerror(error));
+  return transport;
+}
+#if defined(__linux__)
+int io_service::recv_dgram_batch(xxsocket* sock, int& error)
+{
+  auto& batch    = this->dgram_batch_;
+  const int size = options_.udp_recv_batch_;
+  batch.count_ = batch.index_ = 0;
+  if (static_cast<int>(batch.recv_hdrs_.size()) != size)
+  { // allocate at first use or batch size changed
+    batch.recv_hdrs_.resize(size);
+    batch.recv_bufs_.resize(size);
+    batch.peers_.resize(size);
+    batch.data_.resize(static_cast<size_t>(size) * YASIO_INET_BUFFER_SIZE);
+    batch.cmsgs_.resize(static_cast<size_t>(size) * CMSG_SPACE(sizeof(int)));
+  }
+  for (int i = 0; i < size; ++i)
+  { // the kernel updates msg_namelen, msg_controllen and msg_len, so reset all every call
+    auto& hdr                  = batch.recv_hdrs_[i];
+    batch.recv_bufs_[i]        = iovec{&batch.data_[static_cast<size_t>(i) * YASIO_INET_BUFFER_SIZE], YASIO_INET_BUFFER_SIZE};
+    hdr.msg_hdr                = msghdr{};
+    hdr.msg_hdr.msg_name       = &batch.peers_[i].sa_;
+    hdr.msg_hdr.msg_namelen    = sizeof(ip::endpoint);
+    hdr.msg_hdr.msg_iov        = &batch.recv_bufs_[i];
+    hdr.msg_hdr.msg_iovlen     = 1;
+    hdr.msg_hdr.msg_control    = &batch.cmsgs_[static_cast<size_t>(i) * CMSG_SPACE(sizeof(int))];
+    hdr.msg_hdr.msg_controllen = CMSG_SPACE(sizeof(int));
+    hdr.msg_len                = 0;
+  }
+
+  int count = ::recvmmsg(sock->native_handle(), batch.recv_hdrs_.data(), static_cast<unsigned int>(size), 0, nullptr);
+  if (count > 0)
+  {
+    batch.dgrams_.clear();
+    for (int i = 0; i < count; ++i)
+    {
+      auto& hdr = batch.recv_hdrs_[i];
+      batch.peers_[i].len(hdr.msg_hdr.msg_namelen);
+      if (yasio__unlikely(hdr.msg_hdr.msg_flags & MSG_TRUNC))
+      { // the datagram exceeds YASIO_INET_BUFFER_SIZE, drop it rather than deliver a truncated one
+        YASIO_KLOGE("[socket.fd: %d] the datagram from %s exceeds recv buffer size %d, dropped", (int)sock->native_handle(), batch.peers_[i].to_string().c_str(),
+                    YASIO_INET_BUFFER_SIZE);
+        continue;
+      }
+
+      // split the datagrams coalesced by UDP_GRO with segment size
+      int gso_size = 0;
+      for (auto cmsg = CMSG_FIRSTHDR(&hdr.msg_hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr.msg_hdr, cmsg))
+        if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO)
+          ::memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+      auto data       = static_cast<const char*>(hdr.msg_hdr.msg_iov->iov_base);
+      const int total = static_cast<int>(hdr.msg_len);
+      if (gso_size <= 0)
+        gso_size = total;
+      int offset = 0;
+      do
+      {
+        batch.dgrams_.push_back({data + offset, (std::min)(gso_size, total - offset), i});
+        offset += gso_size;
+      } while (offset < total);
+    }
+    if (batch.transports_.size() < batch.dgrams_.size())
+      batch.transports_.resize(batch.dgrams_.size());
+    batch.count_ = static_cast<int>(batch.dgrams_.size());
+    return batch.count_;
+  }
+  if (count < 0)
+  {
+    error = xxsocket::get_last_errno();
+    if (!xxsocket::not_recv_error(error))
+      return -1;
+    error = 0; // status ok, clear error
+  }
+  return 0;
+}
+#endif
 transport_handle_t io_service::do_dgram_accept(io_channel* ctx, const ip::endpoint& peer, int& error)
 {
+  if (yasio__testbits(ctx->properties_, YCF_UDP_SHARED_SOCKET))
+  { // the pseudo transport reply with sendto on listening socket, the datagrams are dispatched by channel
+    auto transport            = static_cast<io_transport_udp*>(allocate_transport(ctx, ctx->socket_));
+    transport->shared_socket_ = true;
+    transport->peer_          = peer;
+    transport->destination_   = peer;
+    ctx->dgram_peers_.emplace(peer, transport);
+    notify_connect_succeed(transport);
+    return transport;
+  }
+
   auto new_sock = std::make_shared<xxsocket>();
   if (new_sock->open(peer.af(), SOCK_DGRAM))
   {
@@ -1753,7 +2662,10 @@ void io_service::notify_connect_succeed(transport_handle_t t)
 {
   auto ctx = t->ctx_;
   auto& s  = t->socket_;
-  this->transports_.push_back(t);
+  this->insert_transport(t);
+  if (!t->shared_socket_)
+    this->fd_transports_[s->native_handle()] = t;
+  this->activate(t);
   YASIO_KLOGV("[index: %d] sndbuf=%d, rcvbuf=%d", ctx->index_, s->get_optval<int>(SOL_SOCKET, SO_SNDBUF), s->get_optval<int>(SOL_SOCKET, SO_RCVBUF));
   YASIO_KLOGD("[index: %d] the connection #%u(%p) [%s] --> [%s] is established.", ctx->index_, t->id_, t, t->local_endpoint().to_string().c_str(),
               t->remote_endpoint().to_string().c_str());
@@ -1802,7 +2714,10 @@ void io_service::deallocate_transport(transport_handle_t t)
 {
   if (t && t->is_valid())
   {
-    t->invalid();
+    {
+      std::lock_guard<std::recursive_mutex> lck(this->wakeup_mtx_);
+      t->invalid(); // the user thread can't wakeup or close it any more
+    }
     yasio::invoke_dtor(t);
     this->tpool_.push_back(t);
   }
@@ -1814,42 +2729,83 @@ void io_service::handle_connect_failed(io_channel* ctx, int error)
   YASIO_KLOGE("[index: %d] connect server %s failed, ec=%d, detail:%s", ctx->index_, ctx->format_destination().c_str(), error, io_service::strerror(error));
   handle_event(cxx14::make_unique<io_event>(ctx->index_, YEK_ON_OPEN, error, ctx));
 }
-bool io_service::do_read(transport_handle_t transport, fd_set* fds_array)
+bool io_service::do_read(transport_handle_t transport)
 {
   bool ret = false;
-  do
+#if defined(YASIO_ENABLE_SHARED_RECV_BUFFER)
+  transport->attach_buffer(recv_buffer_.data());
+#endif
+  // tcp transport reads until kernel drained or read budget exhausted, the budget avoid one busy transport starving others
+  int budget = yasio__testbits(transport->ctx_->properties_, YCM_TCP) ? options_.read_budget_ : 0;
+  for (;;)
   {
     if (!transport->socket_->is_open())
       break;
     int error  = 0;
-    int revent = FD_ISSET(transport->socket_->native_handle(), &(fds_array[read_op]));
+    int revent = !transport->shared_socket_ ? io_watcher_.is_ready(transport->socket_->native_handle(), YEM_POLLIN) : 0;
+    int space  = transport->rcapacity() - transport->offset_;
     int n      = transport->do_read(revent, error, this->wait_duration_);
+    int nread  = n;
     if (n >= 0)
     {
       YASIO_KLOGV("[index: %d] do_read status ok, bytes transferred: %d, buffer used: %d", transport->cindex(), n, n + transport->offset_);
-      if (transport->expected_size_ == -1)
-      { // decode length
-        int length = transport->ctx_->decode_len_(transport->buffer_, transport->offset_ + n);
-        if (length > 0)
-        {
-          int bytes_to_strip        = ::yasio::clamp(transport->ctx_->uparams_.initial_bytes_to_strip, 0, length - 1);
-          transport->expected_size_ = length;
-          transport->expected_packet_.reserve((std::min)(length - bytes_to_strip,
-                                                         YASIO_MAX_PDU_BUFFER_SIZE)); // #perfomance, avoid memory reallocte.
-          unpack(transport, transport->expected_size_, n, bytes_to_strip);
+      // decode all complete frames in recv buffer at once, the remain bytes are compacted once at end
+      bool ok = true;
+      for (;; n = 0)
+      {
+        if (transport->expected_size_ == -1)
+        { // decode length
+          int length = transport->decode_len(transport->offset_ + n);
+          if (length > 0)
+          {
+            int bytes_to_strip        = ::yasio::clamp(transport->ctx_->uparams_.initial_bytes_to_strip, 0, length - 1);
+            int stream_threshold      = transport->ctx_->uparams_.stream_threshold;
+            transport->expected_size_ = length;
+            if (stream_threshold > 0 && length - bytes_to_strip > stream_threshold)
+            { // stream mode, the oversized frame is delivered in chunks without buffering
+              transport->stream_offset_ = 0;
+              this->handle_event(cxx14::make_unique<io_event>(transport->cindex(), YEK_ON_PACKET_BEGIN, length - bytes_to_strip, transport));
+            }
+            else if (transport->rchunk_ && length <= YASIO_MAX_PDU_BUFFER_SIZE)
+            { // view mode, the frame is received into chunk, copy occurs only when it spans the chunk end
+              transport->reserve_chunk(length, transport->offset_ + n);
+            }
+            else
+            {
+#if !defined(YASIO_DISABLE_PACKET_POOL)
+              transport->expected_packet_ = packet_pool::instance().acquire((std::min)(length - bytes_to_strip, YASIO_MAX_PDU_BUFFER_SIZE));
+#else
+              transport->expected_packet_.reserve((std::min)(length - bytes_to_strip,
+                                                             YASIO_MAX_PDU_BUFFER_SIZE)); // #perfomance, avoid memory reallocte.
+#endif
+            }
+            unpack(transport, transport->expected_size_, n, bytes_to_strip);
+          }
+          else if (length == 0)
+          { // header insufficient, wait readfd ready at next event frame.
+            transport->offset_ += n;
+            break;
+          }
+          else
+          {
+            transport->set_last_errno(yasio::errc::invalid_packet, yasio::io_base::error_stage::READ);
+            ok = false;
+            break;
+          }
         }
-        else if (length == 0) // header insufficient, wait readfd ready at next event frame.
-          transport->offset_ += n;
         else
-        {
-          transport->set_last_errno(yasio::errc::invalid_packet, yasio::io_base::error_stage::READ);
-          break;
+        { // process incompleted pdu, the stripped bytes never stored to expected_packet_
+          int bytes_to_strip = transport->expected_packet_.capacity() != 0
+                                   ? ::yasio::clamp(transport->ctx_->uparams_.initial_bytes_to_strip, 0, transport->expected_size_ - 1)
+                                   : 0;
+          unpack(transport, transport->expected_size_ - bytes_to_strip - static_cast<int>(transport->expected_packet_.size()), n, 0);
         }
+        if (transport->expected_size_ != -1 || transport->offset_ == 0)
+          break; // the frame incomplete or all bytes consumed, otherwise the remain bytes may contain next frame
       }
-      else
-      { // process incompleted pdu
-        unpack(transport, transport->expected_size_ - static_cast<int>(transport->expected_packet_.size()), n, 0);
-      }
+      transport->compact_buffer();
+      if (!ok)
+        break;
     }
     else
     { // n < 0, regard as connection should close
@@ -1857,25 +2813,80 @@ bool io_service::do_read(transport_handle_t transport, fd_set* fds_array)
       break;
     }
     ret = true;
-  } while (false);
+#if defined(__linux__)
+    if (dgram_batch_.index_ < dgram_batch_.count_)
+    { // consume the remain datagrams of udp batch receive
+      ret = false;
+      continue;
+    }
+#endif
+    // the read filled whole buffer space, the remain bytes may pending in kernel, a short read regard as EAGAIN
+    if (nread > 0 && nread >= space && (budget -= nread) > 0)
+      continue;
+    break;
+  }
+#if defined(__linux__)
+  dgram_batch_.count_ = dgram_batch_.index_ = 0; // discard remain datagrams when error occurred
+#endif
+#if defined(YASIO_ENABLE_SHARED_RECV_BUFFER)
+  transport->detach_buffer();
+#endif
   return ret;
 }
 void io_service::unpack(transport_handle_t transport, int bytes_expected, int bytes_transferred, int bytes_to_strip)
 {
   auto& offset         = transport->offset_;
   auto bytes_available = bytes_transferred + offset;
-  transport->expected_packet_.insert(transport->expected_packet_.end(), transport->buffer_ + bytes_to_strip,
-                                     transport->buffer_ + (std::min)(bytes_expected, bytes_available));
+  if (transport->stream_offset_ >= 0)
+  { // stream mode, the received bytes of frame are delivered at once, the stripped bytes are skipped
+    auto& stream_offset = transport->stream_offset_;
+    int bytes_consumed  = (std::min)(bytes_available, transport->expected_size_ - stream_offset);
+    bytes_to_strip      = ::yasio::clamp(transport->ctx_->uparams_.initial_bytes_to_strip, 0, transport->expected_size_ - 1);
+    int bytes_skipped   = ::yasio::clamp(bytes_to_strip - stream_offset, 0, bytes_consumed);
+    if (bytes_consumed > bytes_skipped)
+    {
+#if !defined(YASIO_DISABLE_PACKET_POOL)
+      io_packet chunk = packet_pool::instance().acquire(bytes_consumed - bytes_skipped);
+#else
+      io_packet chunk;
+#endif
+      chunk.assign(transport->rdata() + bytes_skipped, transport->rdata() + bytes_consumed);
+      this->handle_event(
+          cxx14::make_unique<io_event>(transport->cindex(), YEK_ON_PACKET_CHUNK, stream_offset + bytes_skipped - bytes_to_strip, std::move(chunk), transport));
+    }
+    stream_offset += bytes_consumed;
+    transport->rpos_ += bytes_consumed;
+    offset = bytes_available - bytes_consumed;
+    if (stream_offset == transport->expected_size_)
+    {
+      YASIO_KLOGV("[index: %d] received a streaming packet from peer, packet size:%d", transport->cindex(), transport->expected_size_);
+      this->handle_event(cxx14::make_unique<io_event>(transport->cindex(), YEK_ON_PACKET_END, transport->expected_size_ - bytes_to_strip, transport));
+      transport->expected_size_ = -1;
+      stream_offset             = -1;
+    }
+    return;
+  }
+  if (transport->rchunk_ && transport->expected_packet_.capacity() == 0)
+  { // view mode, the frame stays in chunk until completed
+    if (bytes_available < bytes_expected)
+    {
+      offset = bytes_available;
+      return;
+    }
+    offset = bytes_available - bytes_expected;
+    YASIO_KLOGV("[index: %d] received a properly packet from peer, packet size:%d", transport->cindex(), transport->expected_size_);
+    bytes_to_strip = ::yasio::clamp(transport->ctx_->uparams_.initial_bytes_to_strip, 0, bytes_expected - 1);
+    this->handle_event(cxx14::make_unique<io_event>(transport->cindex(), transport->fetch_view(bytes_to_strip), transport));
+    return;
+  }
+  transport->expected_packet_.insert(transport->expected_packet_.end(), transport->rdata() + bytes_to_strip,
+                                     transport->rdata() + (std::min)(bytes_expected, bytes_available));
 
   // set 'offset' to bytes of remain buffer
   offset = bytes_available - bytes_expected;
   if (offset >= 0)
-  { /* pdu received properly */
-    if (offset > 0)
-    { /* move remain data to head of buffer and hold 'offset'. */
-      ::memmove(transport->buffer_, transport->buffer_ + bytes_expected, offset);
-      this->wait_duration_ = yasio__min_wait_duration;
-    }
+  { /* pdu received properly, skip it and hold 'offset', the remain data is decoded by do_read later */
+    transport->rpos_ += bytes_expected;
     // move properly pdu to ready queue, the other thread who care about will retrieve it.
     YASIO_KLOGV("[index: %d] received a properly packet from peer, packet size:%d", transport->cindex(), transport->expected_size_);
     this->handle_event(cxx14::make_unique<io_event>(transport->cindex(), transport->fetch_packet(), transport));
@@ -1901,30 +2912,25 @@ void io_service::schedule_timer(highp_timer* timer_ctl, timer_cb_t&& timer_cb)
     return;
 
   std::lock_guard<std::recursive_mutex> lck(this->timer_queue_mtx_);
-  auto timer_it = this->find_timer(timer_ctl);
-  if (timer_it == timer_queue_.end())
-  {
-    this->timer_queue_.emplace_back(timer_ctl, std::move(timer_cb));
-    this->sort_timers();
-    // If the new timer is earliest, wakup
-    if (timer_ctl == this->timer_queue_.rbegin()->first)
-      this->interrupt();
-  }
-  else // always replace timer_cb
-    timer_it->second = std::move(timer_cb);
+  // always replace timer_cb, and relink the timer with the new expire time
+  timer_ctl->cb_ = std::move(timer_cb);
+  timer_wheel_.remove(timer_ctl);
+  if (timer_wheel_.empty()) // the wheel may not advanced for a long time, catch up now
+    timer_wheel_.advance(highp_clock() / YASIO_TIMER_WHEEL_RESOLUTION);
+
+  auto next_tick = timer_wheel_.next_tick();
+  timer_wheel_.insert(timer_ctl, yasio__expire_tick(timer_ctl->expire_time_));
+  // If the new timer is earliest, wakup
+  if (next_tick == -1 || timer_wheel_.next_tick() < next_tick)
+    this->interrupt();
 }
 void io_service::remove_timer(highp_timer* timer)
 {
   std::lock_guard<std::recursive_mutex> lck(this->timer_queue_mtx_);
-  auto iter = this->find_timer(timer);
-  if (iter != timer_queue_.end())
+  if (timer->linked())
   {
-    timer_queue_.erase(iter);
-    if (!timer_queue_.empty())
-    {
-      this->sort_timers();
-      this->interrupt();
-    }
+    timer_wheel_.remove(timer);
+    timer_cb_t{std::move(timer->cb_)}; // the callback may hold the timer, release it after moved
   }
 }
 void io_service::open_internal(io_channel* ctx)
@@ -1945,6 +2951,7 @@ void io_service::open_internal(io_channel* ctx)
     this->channel_ops_.push_back(ctx);
   this->channel_ops_mtx_.unlock();
 
+  this->rescan_transports_ = true;
   this->interrupt();
 }
 bool io_service::shutdown_internal(transport_handle_t transport)
@@ -1967,67 +2974,57 @@ bool io_service::close_internal(io_channel* ctx)
 }
 void io_service::process_timers()
 {
-  if (this->timer_queue_.empty())
+  if (this->timer_wheel_.empty())
     return;
 
   std::lock_guard<std::recursive_mutex> lck(this->timer_queue_mtx_);
 
-  unsigned int n = 0; // the count expired loop timers
-  while (!this->timer_queue_.empty())
+  timer_wheel_.advance(this->now_ / YASIO_TIMER_WHEEL_RESOLUTION);
+  for (wheel_node* node; (node = timer_wheel_.pop_due()) != nullptr;)
   {
-    auto timer_ctl = timer_queue_.back().first;
-    if (timer_ctl->expired())
-    {
-      // fetch timer
-      auto timer_impl = std::move(timer_queue_.back());
-      timer_queue_.pop_back();
-
-      if (!timer_impl.second(*this))
-      { // reschedule if the timer want wait again
-        timer_ctl->expires_from_now();
-        timer_queue_.push_back(std::move(timer_impl));
-        ++n;
-      }
+    auto timer_ctl = static_cast<highp_timer*>(node);
+    auto timer_cb  = std::move(timer_ctl->cb_);
+    if (!timer_cb(*this) && !timer_ctl->linked())
+    { // reschedule if the timer want wait again, at least next tick
+      timer_ctl->expires_from_now();
+      timer_ctl->cb_ = std::move(timer_cb);
+      timer_wheel_.insert(timer_ctl, (std::max)(yasio__expire_tick(timer_ctl->expire_time_), timer_wheel_.current_tick() + 1));
     }
-    else
-      break;
   }
-  if (n)
-    sort_timers();
 }
-int io_service::do_select(fd_set* fdsa, highp_time_t wait_duration)
+int io_service::do_evpoll(highp_time_t wait_duration)
 {
-  ::memcpy(fdsa, this->fds_array_, sizeof(this->fds_array_));
-  timeval waitd_tv = {(decltype(timeval::tv_sec))(wait_duration / 1000000), (decltype(timeval::tv_usec))(wait_duration % 1000000)};
 #if defined(YASIO_HAVE_CARES)
-  int nfds = -1;
-  if (this->ares_outstanding_work_ > 0 && (nfds = ::ares_fds(this->ares_, &fdsa[read_op], &fdsa[write_op])) > 0)
+  if (this->ares_outstanding_work_ > 0)
   {
-    ::ares_timeout(this->ares_, &waitd_tv, &waitd_tv);
-    if (this->max_nfds_ < nfds)
-      this->max_nfds_ = nfds;
+    register_ares_descriptors();
+    if (!this->ares_fds_.empty())
+    {
+      timeval waitd_tv = {(decltype(timeval::tv_sec))(wait_duration / 1000000), (decltype(timeval::tv_usec))(wait_duration % 1000000)};
+      ::ares_timeout(this->ares_, &waitd_tv, &waitd_tv);
+      wait_duration = static_cast<highp_time_t>(waitd_tv.tv_sec) * 1000000 + waitd_tv.tv_usec;
+    }
   }
 #endif
-  YASIO_KLOGV("[core] socket.select max_nfds_:%d waiting... %ld milliseconds", max_nfds_, waitd_tv.tv_sec * 1000 + waitd_tv.tv_usec / 1000);
-  int retval = ::select(this->max_nfds_, &(fdsa[read_op]), &(fdsa[write_op]), nullptr, &waitd_tv);
-  YASIO_KLOGV("[core] socket.select waked up, retval=%d", retval);
+  YASIO_KLOGV("[core] poll_io waiting... %ld milliseconds", static_cast<long>(wait_duration / 1000));
+  int retval = io_watcher_.poll_io(wait_duration);
+  YASIO_KLOGV("[core] poll_io waked up, retval=%d", retval);
 
   return retval;
 }
 highp_time_t io_service::get_timeout(highp_time_t usec)
 {
-  if (this->timer_queue_.empty())
+  if (this->timer_wheel_.empty())
     return usec;
 
   std::lock_guard<std::recursive_mutex> lck(this->timer_queue_mtx_);
-  auto earliest = timer_queue_.back().first;
+  auto next_tick = timer_wheel_.next_tick();
+  if (next_tick == -1)
+    return usec;
 
   // microseconds
-  auto duration = earliest->wait_duration();
-  if (std::chrono::microseconds(usec) > duration)
-    return duration.count();
-  else
-    return usec;
+  auto duration = (std::max)(next_tick * YASIO_TIMER_WHEEL_RESOLUTION - this->now_, 0LL);
+  return (std::min)(duration, usec);
 }
 bool io_service::cleanup_channel(io_channel* ctx, bool clear_state)
 {
@@ -2044,7 +3041,7 @@ bool io_service::cleanup_io(io_base* obj, bool clear_state)
   obj->opmask_ = 0;
   if (clear_state)
     obj->state_ = io_base::state::CLOSED;
-  if (obj->socket_->is_open())
+  if (obj->socket_->is_open() && !obj->shared_socket_)
   {
     unregister_descriptor(obj->socket_->native_handle(), YEM_POLLIN | YEM_POLLOUT);
     obj->socket_->close();
@@ -2153,6 +3150,81 @@ int io_service::resolve(std::vector<ip::endpoint>& endpoints, const char* hostna
   return -1;
 }
 void io_service::interrupt() { interrupter_.interrupt(); }
+void io_service::activate(transport_handle_t transport)
+{
+  if (!transport->active_)
+  {
+    transport->active_ = true;
+    active_transports_.push_back(transport);
+  }
+}
+void io_service::wakeup(transport_handle_t transport)
+{
+  {
+    // the transport is invalidated under same lock before destroyed, queue the key so the wakeup of closed transport is dropped
+    std::lock_guard<std::recursive_mutex> lck(this->wakeup_mtx_);
+    if (!transport->is_valid())
+      return;
+    if (!transport->wakeup_pending_.exchange(true))
+    {
+      wakeup_transports_.push_back(transport->key());
+      wakeup_requested_ = true;
+    }
+  }
+  this->interrupt();
+}
+void io_service::insert_transport(transport_handle_t transport)
+{
+  transport->pos_ = transports_.size();
+  transports_.push_back(transport);
+
+  std::lock_guard<std::recursive_mutex> lck(this->tslots_mtx_);
+  if (free_tslots_.empty())
+  {
+    free_tslots_.push_back(static_cast<uint32_t>(tslots_.size()));
+    tslots_.push_back(io_transport_slot{nullptr, 1});
+  }
+  auto slot = free_tslots_.back();
+  free_tslots_.pop_back();
+  tslots_[slot].transport = transport;
+  transport->slot_        = slot;
+  transport->generation_  = tslots_[slot].generation;
+}
+void io_service::remove_transport(transport_handle_t transport)
+{
+  auto pos = transport->pos_;
+  if (pos < transports_.size() && transports_[pos] == transport)
+  { // move the last one to the hole
+    transports_[pos]       = transports_.back();
+    transports_[pos]->pos_ = pos;
+    transports_.pop_back();
+
+    std::lock_guard<std::recursive_mutex> lck(this->tslots_mtx_);
+    auto& item     = tslots_[transport->slot_];
+    item.transport = nullptr;
+    ++item.generation; // the keys of closed transport are stale now
+    free_tslots_.push_back(transport->slot_);
+  }
+
+  if (!transport->shared_socket_)
+  { // the listening socket shared by udp peers is never mapped
+    auto fd = transport->socket_->native_handle();
+    if (fd != invalid_socket)
+      fd_transports_.erase(fd);
+    else
+    { // the socket already closed, find by value
+      auto fdit = yasio__find_if(fd_transports_, [=](const std::pair<const socket_native_type, transport_handle_t>& item) { return item.second == transport; });
+      if (fdit != fd_transports_.end())
+        fd_transports_.erase(fdit);
+    }
+  }
+
+  if (transport->active_)
+  {
+    transport->active_ = false;
+    active_transports_.erase(yasio__find(active_transports_, transport));
+  }
+}
 const char* io_service::strerror(int error)
 {
   switch (error)
@@ -2249,6 +3321,19 @@ void io_service::set_option_internal(int opt, va_list ap) // lgtm [cpp/poorly-do
     case YOPT_S_DNS_DIRTY:
       options_.dns_dirty_ = true;
       break;
+    case YOPT_S_UDP_BATCH_SIZE:
+      options_.udp_recv_batch_ = yasio::clamp(va_arg(ap, int), 1, YASIO_MAX_UDP_BATCH);
+      options_.udp_send_batch_ = yasio::clamp(va_arg(ap, int), 1, YASIO_MAX_UDP_BATCH);
+      break;
+    case YOPT_S_ZEROCOPY_THRESHOLD:
+      options_.zerocopy_threshold_ = (std::max)(va_arg(ap, int), 0);
+      break;
+    case YOPT_S_ACCEPT_BUDGET:
+      options_.accept_budget_ = (std::max)(va_arg(ap, int), 1);
+      break;
+    case YOPT_S_READ_BUDGET:
+      options_.read_budget_ = (std::max)(va_arg(ap, int), 0);
+      break;
     case YOPT_C_UNPACK_PARAMS: {
       auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
       if (channel)
@@ -2275,7 +3360,46 @@ void io_service::set_option_internal(int opt, va_list ap) // lgtm [cpp/poorly-do
     case YOPT_C_LFBFD_FN: {
       auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
       if (channel)
-        channel->decode_len_ = *va_arg(ap, decode_len_fn_t*);
+      {
+        channel->decode_len_    = *va_arg(ap, decode_len_fn_t*);
+        channel->decode_len_fp_ = nullptr;
+        channel->framer_        = YUF_LENGTH_FIELD;
+      }
+      break;
+    }
+    case YOPT_C_UNPACK_FRAMER: {
+      auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
+      if (channel)
+      {
+        channel->decode_len_fp_ = nullptr;
+        channel->framer_        = static_cast<u_char>(yasio::clamp(va_arg(ap, int), static_cast<int>(YUF_LENGTH_FIELD), static_cast<int>(YUF_DELIMITER)));
+        if (channel->framer_ == YUF_VARINT)
+          channel->decode_len_ = [channel](void* ptr, int len) { return channel->__builtin_decode_varint(ptr, len); };
+        else
+          channel->decode_len_ = [channel](void* ptr, int len) { return channel->__builtin_decode_len(ptr, len); };
+      }
+      break;
+    }
+    case YOPT_C_UNPACK_DECODER: {
+      auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
+      if (channel)
+        channel->decode_len_fp_ = va_arg(ap, decode_len_fp_t);
+      break;
+    }
+    case YOPT_C_UNPACK_STREAM: {
+      auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
+      if (channel)
+        channel->uparams_.stream_threshold = (std::max)(va_arg(ap, int), 0);
+      break;
+    }
+    case YOPT_C_UNPACK_DELIMITER: {
+      auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
+      if (channel)
+      {
+        const char* delim = va_arg(ap, const char*);
+        if (delim && *delim)
+          channel->delimiter_ = delim;
+      }
       break;
     }
     case YOPT_C_LOCAL_HOST: {
@@ -2357,6 +3481,30 @@ void io_service::set_option_internal(int opt, va_list ap) // lgtm [cpp/poorly-do
       break;
     }
 #endif
+    case YOPT_C_LISTEN_BACKLOG: {
+      auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
+      if (channel)
+        channel->backlog_ = (std::max)(va_arg(ap, int), 1);
+      break;
+    }
+    case YOPT_C_WRITE_WATERMARKS: {
+      auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
+      if (channel)
+      {
+        channel->wparams_.low_watermark  = (std::max)(va_arg(ap, int), 0);
+        channel->wparams_.high_watermark = (std::max)(va_arg(ap, int), 0);
+      }
+      break;
+    }
+    case YOPT_C_WRITE_LIMIT: {
+      auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
+      if (channel)
+      {
+        channel->wparams_.limit  = (std::max)(va_arg(ap, int), 0);
+        channel->wparams_.policy = va_arg(ap, int);
+      }
+      break;
+    }
     case YOPT_T_CONNECT: {
       auto transport = va_arg(ap, transport_handle_t);
       if (transport && transport->is_open() && (transport->ctx_->properties_ & 0xff) == YCK_UDP_CLIENT)
@@ -2383,6 +3531,103 @@ void io_service::set_option_internal(int opt, va_list ap) // lgtm [cpp/poorly-do
     }
   }
 }
+// ------------------------ io_service_group ------------------------
+io_service_group::io_service_group(int concurrency, const io_hostent* channel_eps, int channel_count)
+{
+  if (concurrency <= 0)
+    concurrency = (std::max)(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  services_.reserve(concurrency);
+  for (int i = 0; i < concurrency; ++i)
+    services_.push_back(cxx14::make_unique<io_service>(channel_eps, channel_count));
+}
+io_service_group::~io_service_group() { this->stop(); }
+void io_service_group::start(event_cb_t cb)
+{
+  for (auto& service : services_)
+    service->start(cb);
+}
+void io_service_group::stop()
+{
+  for (auto& service : services_)
+    service->stop();
+}
+void io_service_group::dispatch(int max_count)
+{
+  for (auto& service : services_)
+    service->dispatch(max_count);
+}
+void io_service_group::set_option(int opt, ...)
+{
+  va_list ap;
+  va_start(ap, opt);
+  set_option_internal(opt, ap);
+  va_end(ap);
+}
+void io_service_group::set_option_internal(int opt, va_list ap)
+{
+  switch (opt)
+  {
+    case YOPT_S_NO_NEW_THREAD: // not supported, N loops can't run at the caller thread
+      break;
+    case YOPT_T_CONNECT:
+    case YOPT_T_DISCONNECT: {
+      auto transport = va_arg(ap, transport_handle_t);
+      if (transport)
+        transport->get_context()->get_service().set_option(opt, transport);
+      break;
+    }
+    case YOPT_B_SOCKOPT: // only operate the socket of io_base, apply once
+      services_[0]->set_option_internal(opt, ap);
+      break;
+    default:
+      for (auto& service : services_)
+      {
+        va_list args;
+        va_copy(args, ap);
+        service->set_option_internal(opt, args);
+        va_end(args);
+      }
+  }
+}
+void io_service_group::open(size_t index, int kind)
+{
+#if defined(__linux__)
+  if (yasio__testbits(kind, YCM_SERVER))
+  { // the kernel will spread accepts across the SO_REUSEPORT listeners of all loops
+    for (auto& service : services_)
+    {
+      service->set_option(YOPT_C_MOD_FLAGS, static_cast<int>(index), YCF_REUSEADDR, 0);
+      service->open(index, kind);
+    }
+    return;
+  }
+#endif
+  services_[0]->open(index, kind);
+}
+void io_service_group::close(int index)
+{
+  for (auto& service : services_)
+    service->close(index);
+}
+int io_service_group::write(transport_handle_t transport, std::vector<char> buffer, completion_cb_t handler)
+{
+  return transport ? transport->get_context()->get_service().write(transport, std::move(buffer), std::move(handler)) : -1;
+}
+int io_service_group::write(transport_handle_t transport, shared_buffer_t buffer, completion_cb_t handler)
+{
+  return transport ? transport->get_context()->get_service().write(transport, std::move(buffer), std::move(handler)) : -1;
+}
+int io_service_group::write_to(transport_handle_t transport, std::vector<char> buffer, const ip::endpoint& to, completion_cb_t handler)
+{
+  return transport ? transport->get_context()->get_service().write_to(transport, std::move(buffer), to, std::move(handler)) : -1;
+}
+int io_service_group::broadcast(int cindex, shared_buffer_t buffer)
+{
+  int n = -1;
+  for (auto& service : services_)
+    n = service->broadcast(cindex, buffer);
+  return n;
+}
 } // namespace inet
 } // namespace yasio
 
@@ -31,9 +31,11 @@ SOFTWARE.
 #include <algorithm>
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include <chrono>
 #include <functional>
@@ -44,8 +46,11 @@ SOFTWARE.
 #include "yasio/detail/config.hpp"
 #include "yasio/detail/endian_portable.hpp"
 #include "yasio/detail/object_pool.hpp"
+#include "yasio/detail/packet_pool.hpp"
 #include "yasio/detail/singleton.hpp"
 #include "yasio/detail/select_interrupter.hpp"
+#include "yasio/detail/io_watcher.hpp"
+#include "yasio/detail/timing_wheel.hpp"
 #include "yasio/detail/concurrent_queue.hpp"
 #include "yasio/detail/utils.hpp"
 #include "yasio/cxx17/memory.hpp"
@@ -168,6 +173,35 @@ enum
   //        b. you should set this option after your mobile network changed
   YOPT_S_DNS_DIRTY,
 
+  // Sets udp batch io size, the datagrams count of one recvmmsg/sendmmsg call
+  // params: recv_batch:int(8), send_batch:int(8)
+  // remarks:
+  //        a. only works on linux, other platforms always recv/send one datagram per call
+  //        b. the value will be clamped to [1, YASIO_MAX_UDP_BATCH], 1 to disable batch io
+  //        c. the recv batch takes recv_batch * YASIO_INET_BUFFER_SIZE bytes memory per io_service
+  YOPT_S_UDP_BATCH_SIZE,
+
+  // Sets tcp zero-copy send threshold, the ops not less than it are sent with MSG_ZEROCOPY
+  // params: threshold:int(0)
+  // remarks:
+  //        a. only works on linux 4.14+ for tcp transports except ssl, 0 to disable
+  //        b. the completion handler of op is invoked after kernel release the pages
+  //        c. the zero-copy is stopped for the transport when kernel reports data was copied, such as loopback
+  //        d. it only benefits large payloads, the kernel recommends threshold above 10KB
+  YOPT_S_ZEROCOPY_THRESHOLD,
+
+  // Sets the max tcp connections accepted by a server channel per loop iteration
+  // params: budget:int(64)
+  // remarks: the server accepts until EAGAIN or budget exhausted, the remain connections are accepted next iteration
+  YOPT_S_ACCEPT_BUDGET,
+
+  // Sets the max bytes of a tcp transport to read per loop iteration
+  // params: budget:int(262144)
+  // remarks:
+  //        a. the transport reads until EAGAIN or budget exhausted, the remain bytes are read next iteration
+  //        b. 0 to read once per loop iteration
+  YOPT_S_READ_BUDGET,
+
   // Sets channel length field based frame decode function, native C++ ONLY
   // params: index:int, func:decode_len_fn_t*
   YOPT_C_LFBFD_FN = 101,
@@ -229,6 +263,53 @@ enum
   // params: index:int, conv:int
   YOPT_C_KCP_CONV,
 
+  // Sets the listen backlog of tcp server channel
+  // params: index:int, backlog:int(YASIO_SOMAXCONN)
+  // remarks: takes effect at next open, the kernel may clamp it, i.e. net.core.somaxconn on linux
+  YOPT_C_LISTEN_BACKLOG,
+
+  // Sets the send queue watermarks of channel transports
+  // params: index:int, low:int(0), high:int(0)
+  // remarks: YEK_ON_WRITE_BLOCKED is triggered when the queued bytes reach high, then YEK_ON_WRITE_DRAINED
+  // is triggered when they fall to low, 0 high to disable. The events are checked after do_write at io_service
+  // thread, so the producers may overshoot high by the bytes written in one loop tick, use YOPT_C_WRITE_LIMIT to cap it
+  YOPT_C_WRITE_WATERMARKS,
+
+  // Sets the hard limit of send queue of channel transports
+  // params: index:int, limit:int(0), policy:int(YWLP_REJECT)
+  // remarks: the write which makes queued bytes exceed limit fails, 0 limit to disable, the bytes
+  // are reserved atomically, so the concurrent writers never exceed it
+  YOPT_C_WRITE_LIMIT,
+
+  // Sets channel builtin frame decoder
+  // params: index:int, framer:int(YUF_LENGTH_FIELD)
+  // remarks:
+  //        a. YUF_VARINT: the 7-bit encoded payload length written by obstream::write_ix, the length_field_offset(negative
+  //           regard as 0), length_adjustment and max_frame_length of YOPT_C_UNPACK_PARAMS also apply
+  //        b. YUF_DELIMITER: the frame ends with delimiter, see YOPT_C_UNPACK_DELIMITER, the delimiter is kept in packet,
+  //           the max frame length is min(max_frame_length, YASIO_INET_BUFFER_SIZE)
+  //        c. the decode function set by YOPT_C_LFBFD_FN is replaced
+  YOPT_C_UNPACK_FRAMER,
+
+  // Sets channel delimiter of YUF_DELIMITER frame decoder
+  // params: index:int, delim:const char*("\n")
+  YOPT_C_UNPACK_DELIMITER,
+
+  // Sets channel compile-time specialized frame decode function, native C++ ONLY
+  // params: index:int, func:decode_len_fp_t, i.e. &yasio::fixed_length_field<0, 4>::decode_len
+  // remarks: takes place of the builtin framers and decode function set by YOPT_C_LFBFD_FN, nullptr to restore them
+  YOPT_C_UNPACK_DECODER,
+
+  // Sets channel streaming threshold of oversized frames
+  // params: index:int, threshold:int(0)
+  // remarks:
+  //        a. the frame which payload exceeds threshold isn't buffered, it's delivered as YEK_ON_PACKET_BEGIN,
+  //           YEK_ON_PACKET_CHUNK events of received bytes, YEK_ON_PACKET_END in order
+  //        b. the transport closed in the middle of frame has no YEK_ON_PACKET_END, the YEK_ON_CLOSE follows
+  //           the last YEK_ON_PACKET_CHUNK, the partial frame should be discarded
+  //        c. 0 to disable
+  YOPT_C_UNPACK_STREAM,
+
   // Change 4-tuple association for io_transport_udp
   // params: transport:transport_handle_t
   // remarks: only works for udp client transport
@@ -278,6 +359,36 @@ enum
      https://docs.microsoft.com/en-us/windows/win32/winsock/using-so-reuseaddr-and-so-exclusiveaddruse
   */
   YCF_EXCLUSIVEADDRUSE = 1 << 10,
+
+  /* For udp/kcp on linux, send datagrams of same size in one sendmsg with UDP_SEGMENT and receive
+     coalesced datagrams with UDP_GRO, automatic fallback when kernel or device not support
+  */
+  YCF_UDP_GSO = 1 << 11,
+
+  /* For tcp/ssl, receive into refcounted chunks and deliver complete frames as io_packet_view
+     without copy, only the partial frame at chunk end is copied to the next chunk
+  */
+  YCF_PACKET_VIEW = 1 << 12,
+
+  /* For udp/kcp server, all peers share the listening socket instead of one connected socket per peer,
+     the datagrams are demultiplexed to transports by peer endpoint and replies are sent with sendto
+  */
+  YCF_UDP_SHARED_SOCKET = 1 << 13,
+};
+
+// the policies when send queue exceeds hard limit, see YOPT_C_WRITE_LIMIT
+enum
+{
+  YWLP_REJECT, // the write fails
+  YWLP_CLOSE,  // the write fails and the transport is closed
+};
+
+// the builtin frame decoders of channel, see YOPT_C_UNPACK_FRAMER
+enum
+{
+  YUF_LENGTH_FIELD, // fixed width length field, see YOPT_C_UNPACK_PARAMS
+  YUF_VARINT,       // 7-bit encoded length prefix
+  YUF_DELIMITER,    // delimiter terminated, such as '\n', "\r\n"
 };
 
 // event kinds
@@ -286,6 +397,11 @@ enum
   YEK_ON_OPEN = 1,
   YEK_ON_CLOSE,
   YEK_ON_PACKET,
+  YEK_ON_WRITE_BLOCKED, // the queued bytes reach high watermark, the status is queued bytes
+  YEK_ON_WRITE_DRAINED, // the queued bytes fall to low watermark, the status is queued bytes
+  YEK_ON_PACKET_BEGIN,  // the oversized frame begins, the status is payload size, see YOPT_C_UNPACK_STREAM
+  YEK_ON_PACKET_CHUNK,  // the bytes of oversized frame, the status is offset in payload
+  YEK_ON_PACKET_END,    // the oversized frame ends, the status is payload size
   YEK_CONNECT_RESPONSE = YEK_ON_OPEN,
   YEK_CONNECTION_LOST  = YEK_ON_CLOSE,
   YEK_PACKET           = YEK_ON_PACKET,
@@ -321,6 +437,24 @@ enum
 class highp_timer;
 class io_send_op;
 class io_sendto_op;
+/*
+** The length field based frame decoder specialized at compile time, the unpack params are constants, so the
+** decode is inlined to a plain function without std::function dispatch and runtime branches, see YOPT_C_UNPACK_DECODER
+*/
+template <int _Offset, int _Bytes, typename _Endian = yasio::network_convert_tag, int _Adjust = 0, int _MaxFrameLength = YASIO_SZ(10, M)>
+struct fixed_length_field {
+  static_assert(_Offset >= 0 && _Bytes >= 1 && _Bytes <= YASIO_SSIZEOF(int), "the length field must be 1~4 bytes");
+  static int decode_len(void* d, int n)
+  {
+    if (n < _Offset + _Bytes)
+      return 0;
+    int len = 0;
+    ::memcpy(&len, static_cast<uint8_t*>(d) + _Offset, _Bytes);
+    len = yasio::convert_traits<_Endian>::fromint(len, _Bytes) + _Adjust;
+    return len <= _MaxFrameLength ? len : -1;
+  }
+};
+
 class io_event;
 class io_channel;
 class io_transport;
@@ -332,18 +466,25 @@ class io_service;
 
 // recommand user always use transport_handle_t, in the future, it's maybe void* or intptr_t
 typedef io_transport* transport_handle_t;
+// The generational handle of transport, bit[1-32]: slot index, bit[33-64]: generation of slot,
+// it never refers to another transport after the transport closed, 0 is invalid
+typedef uint64_t transport_key_t;
 
 // typedefs
 typedef std::unique_ptr<io_send_op> send_op_ptr;
 typedef std::unique_ptr<io_event> event_ptr;
 typedef std::shared_ptr<highp_timer> highp_timer_ptr;
 
+// the refcounted immutable payload, can be written to many transports without copy
+typedef std::shared_ptr<const std::vector<char>> shared_buffer_t;
+
 typedef std::function<bool(io_service&)> timer_cb_t;
 typedef std::function<void(io_service&)> timerv_cb_t;
 typedef std::function<void(event_ptr&&)> event_cb_t;
 typedef std::function<bool(event_ptr&)> defer_event_cb_t;
 typedef std::function<void(int, size_t)> completion_cb_t;
 typedef std::function<int(void* d, int n)> decode_len_fn_t;
+typedef int (*decode_len_fp_t)(void* d, int n);
 typedef std::function<int(std::vector<ip::endpoint>&, const char*, unsigned short)> resolv_fn_t;
 typedef std::function<void(const char*)> print_fn_t;
 typedef std::function<void(int level, const char*)> print_fn2_t;
@@ -369,7 +510,9 @@ struct io_hostent {
   u_short port_ = 0;
 };
 
-class YASIO_API highp_timer {
+class YASIO_API highp_timer : private wheel_node {
+  friend class io_service;
+
 public:
   highp_timer()                   = default;
   highp_timer(const highp_timer&) = delete;
@@ -412,6 +555,9 @@ public:
 
   std::chrono::microseconds duration_                  = {};
   std::chrono::time_point<steady_clock_t> expire_time_ = {};
+
+private:
+  timer_cb_t cb_; // the callback when scheduled
 };
 
 struct YASIO_API io_base {
@@ -432,8 +578,8 @@ struct YASIO_API io_base {
   };
   io_base() : error_(0), state_(state::CLOSED), opmask_(0)
   {
-    static unsigned int s_object_id = 0;
-    this->id_                       = ++s_object_id;
+    static std::atomic<unsigned int> s_object_id{0}; // the channels may be added at any thread
+    this->id_ = ++s_object_id;
   }
   virtual ~io_base() {}
 
@@ -458,6 +604,8 @@ struct YASIO_API io_base {
 
   // mark whether pollout event registerred.
   bool pollout_registerred_ = false;
+  // mark whether the socket is owned by server channel, see YCF_UDP_SHARED_SOCKET
+  bool shared_socket_ = false;
   std::atomic<state> state_;
   uint8_t opmask_;
   unsigned int id_;
@@ -540,6 +688,9 @@ private:
 
   // -1 indicate failed, connection will be closed
   YASIO__DECL int __builtin_decode_len(void* d, int n);
+  YASIO__DECL int __builtin_decode_varint(void* d, int n);
+  // The 'scanned' is the resume offset of the scan, bytes before it never start a delimiter
+  YASIO__DECL int __builtin_decode_delim(void* d, int n, int& scanned);
 
   io_service& service_;
 
@@ -584,9 +735,25 @@ private:
     int length_field_length    = 4;               // 1,2,3,4
     int length_adjustment      = 0;
     int initial_bytes_to_strip = 0;
+    int stream_threshold       = 0; // 0: disabled, > 0: the frame which payload exceeds it is delivered in chunks
   } uparams_;
+
+  // The send queue watermarks and hard limit of transports, 0: disabled
+  struct __unnamed02 {
+    int low_watermark  = 0;
+    int high_watermark = 0;
+    int limit          = 0;
+    int policy         = YWLP_REJECT;
+  } wparams_;
   decode_len_fn_t decode_len_;
 
+  // The compile-time specialized decode function, preferred when set
+  decode_len_fp_t decode_len_fp_ = nullptr;
+
+  // The builtin frame decoder and the delimiter of YUF_DELIMITER
+  u_char framer_ = YUF_LENGTH_FIELD;
+  std::string delimiter_ = "\n";
+
   /*
   !!! for tcp/udp client to bind local specific network adapter, empty for any
   */
@@ -606,11 +773,17 @@ private:
   // Current it's only for UDP
   std::vector<char> buffer_;
 
+  // The transports of udp server with YCF_UDP_SHARED_SOCKET, keyed by peer endpoint
+  std::unordered_map<ip::endpoint, transport_handle_t, ip::endpoint_hash, ip::endpoint_equal_to> dgram_peers_;
+
   // The bytes transferred from socket low layer, currently, only works for client channel
   long long bytes_transferred_ = 0;
 
   unsigned int connect_id_ = 0;
 
+  // The listen backlog of tcp server
+  int backlog_ = YASIO_SOMAXCONN;
+
 #if defined(YASIO_HAVE_KCP)
   int kcp_conv_ = 0;
 #endif
@@ -624,18 +797,47 @@ private:
 #endif
 };
 
+inline shared_buffer_t make_shared_buffer(std::vector<char> buffer) { return std::make_shared<std::vector<char>>(std::move(buffer)); }
+
+// A received frame refers to the recv chunk of transport, see YCF_PACKET_VIEW
+class io_packet_view {
+public:
+  io_packet_view() {}
+  io_packet_view(std::shared_ptr<char> chunk, int offset, int size) : chunk_(std::move(chunk)), offset_(offset), size_(size) {}
+
+  const char* data() const { return chunk_.get() + offset_; }
+  int size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Copy the frame out, the chunk can be reused by transport after all views of it released
+  std::vector<char> to_packet() const { return std::vector<char>(data(), data() + size_); }
+
+private:
+  std::shared_ptr<char> chunk_;
+  int offset_ = 0;
+  int size_   = 0;
+};
+
 // for tcp transport only
-class YASIO_API io_send_op {
+class YASIO_API io_send_op : public privacy::mpsc_node {
 public:
   io_send_op(std::vector<char>&& buffer, completion_cb_t&& handler) : offset_(0), buffer_(std::move(buffer)), handler_(std::move(handler)) {}
+  io_send_op(const shared_buffer_t& buffer, completion_cb_t&& handler) : offset_(0), shared_buffer_(buffer), handler_(std::move(handler)) {}
   virtual ~io_send_op() {}
 
-  size_t offset_;            // read pos from sending buffer
-  std::vector<char> buffer_; // sending data buffer
+  // the sending data, from the shared buffer if present
+  const char* data() const { return shared_buffer_ ? shared_buffer_->data() : buffer_.data(); }
+  size_t size() const { return shared_buffer_ ? shared_buffer_->size() : buffer_.size(); }
+
+  size_t offset_;                 // read pos from sending buffer
+  std::vector<char> buffer_;      // sending data buffer
+  shared_buffer_t shared_buffer_; // sending data buffer shared with other ops
   completion_cb_t handler_;
 
   YASIO__DECL virtual int perform(transport_handle_t transport, const void* buf, int n);
 
+  virtual const ip::endpoint* destination() const { return nullptr; }
+
 #if !defined(YASIO_DISABLE_OBJECT_POOL)
   DEFINE_CONCURRENT_OBJECT_POOL_ALLOCATION(io_send_op, 512)
 #endif
@@ -647,8 +849,13 @@ public:
   io_sendto_op(std::vector<char>&& buffer, completion_cb_t&& handler, const ip::endpoint& destination)
       : io_send_op(std::move(buffer), std::move(handler)), destination_(destination)
   {}
+  io_sendto_op(const shared_buffer_t& buffer, completion_cb_t&& handler, const ip::endpoint& destination)
+      : io_send_op(buffer, std::move(handler)), destination_(destination)
+  {}
 
   YASIO__DECL int perform(transport_handle_t transport, const void* buf, int n) override;
+
+  const ip::endpoint* destination() const override { return &destination_; }
 #if !defined(YASIO_DISABLE_OBJECT_POOL)
   DEFINE_CONCURRENT_OBJECT_POOL_ALLOCATION(io_sendto_op, 512)
 #endif
@@ -671,6 +878,12 @@ public:
 
   io_channel* get_context() const { return ctx_; }
 
+  // The generational handle, the write with it fails when transport closed, even the memory reused
+  transport_key_t key() const { return (static_cast<transport_key_t>(generation_) << 32) | slot_; }
+
+  // The bytes in send queue, not include the data queued by kcp internal
+  size_t queued_bytes() const { return queued_bytes_; }
+
   virtual ~io_transport() { send_queue_.clear(); }
 
 protected:
@@ -681,6 +894,43 @@ protected:
     expected_size_ = -1;
     return std::move(expected_packet_);
   }
+  io_packet_view fetch_view(int bytes_to_strip)
+  {
+    io_packet_view view(rchunk_, rpos_ + bytes_to_strip, expected_size_ - bytes_to_strip);
+    rpos_ += expected_size_;
+    expected_size_ = -1;
+    return view;
+  }
+
+  // The unconsumed data and capacity of recv buffer, the chunk in view mode
+  char* rdata() { return rchunk_ ? rchunk_.get() + rpos_ : buffer_ + rpos_; }
+  int rcapacity() const { return rchunk_ ? rchunk_size_ - rpos_ : YASIO_INET_BUFFER_SIZE - rpos_; }
+  // Move the unconsumed data to head of recv buffer after the complete frames decoded, the chunk is rewound by do_read
+  void compact_buffer()
+  {
+    if (!rchunk_ && rpos_ > 0)
+    {
+      ::memmove(buffer_, buffer_ + rpos_, offset_);
+      rpos_ = 0;
+    }
+  }
+  // Decode the frame length of 'n' bytes unconsumed data, the delimiter scan resumes from last read
+  int decode_len(int n)
+  {
+    if (ctx_->decode_len_fp_)
+      return ctx_->decode_len_fp_(rdata(), n);
+    return ctx_->framer_ != YUF_DELIMITER ? ctx_->decode_len_(rdata(), n) : ctx_->__builtin_decode_delim(rdata(), n, scan_offset_);
+  }
+  // Ensure the chunk can hold 'need' bytes from the unconsumed data, rewind or switch to a new chunk if necessary,
+  // the 'bytes_used' of unconsumed data are preserved
+  YASIO__DECL void reserve_chunk(int need, int bytes_used);
+
+#if defined(YASIO_ENABLE_SHARED_RECV_BUFFER)
+  // Borrow the recv buffer of io_service and restore the partial frame to it
+  YASIO__DECL void attach_buffer(char* buffer);
+  // Save the partial frame to heap and give back the recv buffer
+  YASIO__DECL void detach_buffer();
+#endif
 
   // For log macro only
   YASIO__DECL const print_fn2_t& __get_cprint() const;
@@ -688,6 +938,9 @@ protected:
   // Call at user thread
   YASIO__DECL virtual int write(std::vector<char>&&, completion_cb_t&&);
 
+  // Call at user thread or io_service thread, write the shared buffer without copy
+  YASIO__DECL virtual int write_shared(const shared_buffer_t&, completion_cb_t&&);
+
   // Call at user thread
   virtual int write_to(std::vector<char>&&, const ip::endpoint&, completion_cb_t&&)
   {
@@ -697,6 +950,8 @@ protected:
 
   YASIO__DECL int call_read(void* data, int size, int& error);
   YASIO__DECL int call_write(io_send_op*, int& error);
+  // Send the op and the queued ops after it with one call if possible, returns the bytes transferred
+  YASIO__DECL virtual int call_writev(io_send_op*, int& error);
   YASIO__DECL void complete_op(io_send_op*, int error);
 
   // Call at io_service
@@ -713,18 +968,52 @@ protected:
   bool is_valid() const { return state_ == io_base::state::OPEN; }
   void invalid() { state_ = io_base::state::CLOSED; }
 
+#if !defined(YASIO_ENABLE_SHARED_RECV_BUFFER)
   char buffer_[YASIO_INET_BUFFER_SIZE]; // recv buffer, 64K
-  int offset_ = 0;                      // recv buffer offset
+#else
+  char* buffer_ = nullptr;    // recv buffer, the 64K buffer of io_service, only available in io_service::do_read
+  std::vector<char> pending_; // the partial frame between reads
+#endif
+  int offset_ = 0; // recv buffer offset
+
+  // The recv chunk shared with io_packet_view, only available when YCF_PACKET_VIEW set
+  std::shared_ptr<char> rchunk_;
+  int rchunk_size_ = 0;
+  int rpos_        = 0; // start of unconsumed data in chunk or recv buffer
 
   int expected_size_ = -1;
   std::vector<char> expected_packet_;
+  // The resume offset of delimiter scan of incomplete frame
+  int scan_offset_ = 0;
+  // The bytes of oversized frame consumed, -1: the frame is buffered, see YOPT_C_UNPACK_STREAM
+  int stream_offset_ = -1;
 
   io_channel* ctx_;
 
+  // The slot in transport table of io_service and generation of the slot, see transport_key_t
+  uint32_t slot_       = 0;
+  uint32_t generation_ = 0;
+  // The index in transport list of io_service, for O(1) remove
+  size_t pos_ = 0;
+
+  // whether in the active list of io_service, only access at io_service thread
+  bool active_ = false;
+  // whether in the wakeup list of io_service
+  std::atomic<bool> wakeup_pending_{false};
+
   std::function<int(const void*, int, const ip::endpoint*)> write_cb_;
   std::function<int(void*, int)> read_cb_;
+  // The gather write primitive, only available for stream transport which can merge outgoing data
+  std::function<int(const iobuf*, int)> writev_cb_;
 
-  privacy::concurrent_queue<send_op_ptr> send_queue_;
+  // The min size of op to send with MSG_ZEROCOPY, 0: disabled, the gather write stops at such op
+  size_t zerocopy_threshold_ = 0;
+
+  privacy::mpsc_queue<io_send_op> send_queue_;
+  // The total size of ops in send queue, increased at user thread and decreased at io_service thread
+  std::atomic<size_t> queued_bytes_{0};
+  // whether YEK_ON_WRITE_BLOCKED triggered and waiting for drained, only access at io_service thread
+  bool write_blocked_ = false;
 };
 
 class YASIO_API io_transport_tcp : public io_transport {
@@ -732,6 +1021,30 @@ class YASIO_API io_transport_tcp : public io_transport {
 
 public:
   io_transport_tcp(io_channel* ctx, std::shared_ptr<xxsocket>& s);
+
+protected:
+  YASIO__DECL void set_primitives() override;
+
+#if defined(__linux__)
+  YASIO__DECL bool do_write(highp_time_t& wait_duration) override;
+
+  // Call at io_service, send the large op with MSG_ZEROCOPY
+  YASIO__DECL int call_writev(io_send_op*, int& error) override;
+  YASIO__DECL int call_zerocopy_write(io_send_op*, int& error);
+
+  // Call at io_service, reap the notifications of socket error queue, complete the ops released by kernel
+  YASIO__DECL void reap_zerocopy();
+
+  struct zerocopy_op {
+    uint32_t first;   // the sequence of first MSG_ZEROCOPY send
+    uint32_t last;    // the sequence of last MSG_ZEROCOPY send
+    uint32_t pending; // the sends not released by kernel
+    send_op_ptr op;   // nullptr: the op still in sending
+  };
+  // the ops which sent with MSG_ZEROCOPY, keep the buffers alive until kernel release the pages
+  std::deque<zerocopy_op> zerocopy_ops_;
+  uint32_t zerocopy_seq_ = 0; // the sequence of next MSG_ZEROCOPY send
+#endif
 };
 #if defined(YASIO_SSL_BACKEND)
 class io_transport_ssl : public io_transport_tcp {
@@ -761,10 +1074,17 @@ protected:
   YASIO__DECL int disconnect();
 
   YASIO__DECL int write(std::vector<char>&&, completion_cb_t&&) override;
+  YASIO__DECL int write_shared(const shared_buffer_t&, completion_cb_t&&) override;
   YASIO__DECL int write_to(std::vector<char>&&, const ip::endpoint&, completion_cb_t&&) override;
 
   YASIO__DECL void set_primitives() override;
 
+  // Call at io_service, receive datagrams with recvmmsg if batch io enabled
+  YASIO__DECL int do_read(int revent, int& error, highp_time_t& wait_duration) override;
+
+  // Call at io_service, send queued datagrams with sendmmsg if batch io enabled
+  YASIO__DECL int call_writev(io_send_op*, int& error) override;
+
   // ensure destination for sendto valid, if not, assign from ctx_->remote_eps_[0]
   YASIO__DECL const ip::endpoint& ensure_destination() const;
 
@@ -774,9 +1094,20 @@ protected:
   // process received data from low level
   YASIO__DECL virtual int handle_input(const char* buf, int bytes_transferred, int& error, highp_time_t& wait_duration);
 
+#if defined(__linux__)
+  // Call at io_service, send the queued datagrams of same size and destination with UDP_SEGMENT
+  // returns: bytes transferred, 0: not sent, -1: gso not available, caller should fallback
+  YASIO__DECL int call_gso_write(io_send_op*, int& error);
+
+  // whether receive datagrams via batch, the coalesced datagrams of UDP_GRO must be split by batch
+  YASIO__DECL bool recv_batch_enabled() const;
+#endif
+
   ip::endpoint peer_;                // for recv only, unstable
   mutable ip::endpoint destination_; // for sendto only, stable
   bool connected_ = false;
+  bool gso_       = false; // UDP_SEGMENT available
+  bool gro_       = false; // UDP_GRO enabled
 };
 #if defined(YASIO_HAVE_KCP)
 class io_transport_kcp : public io_transport_udp {
@@ -787,6 +1118,7 @@ public:
 
 protected:
   YASIO__DECL int write(std::vector<char>&&, completion_cb_t&&) override;
+  YASIO__DECL int write_shared(const shared_buffer_t&, completion_cb_t&&) override;
 
   YASIO__DECL int do_read(int revent, int& error, highp_time_t& wait_duration) override;
   YASIO__DECL bool do_write(highp_time_t& wait_duration) override;
@@ -795,7 +1127,9 @@ protected:
 
   YASIO__DECL void check_timeout(highp_time_t& wait_duration) const;
 
+#if !defined(YASIO_ENABLE_SHARED_RECV_BUFFER)
   std::vector<char> rawbuf_; // the low level raw buffer
+#endif
   ikcpcb* kcp_;
   std::recursive_mutex send_mtx_;
 };
@@ -814,7 +1148,17 @@ inline io_packet::pointer packet_data(packet_t& pkt) { return pkt.data(); }
 inline io_packet::size_type packet_len(packet_t& pkt) { return pkt.size(); }
 #else
 using packet_t = std::shared_ptr<io_packet>;
+#  if !defined(YASIO_DISABLE_PACKET_POOL)
+inline packet_t wrap_packet(io_packet& raw_packet)
+{
+  return packet_t(new io_packet(std::move(raw_packet)), [](io_packet* pkt) {
+    packet_pool::instance().release(*pkt);
+    delete pkt;
+  });
+}
+#  else
 inline packet_t wrap_packet(io_packet& raw_packet) { return std::make_shared<io_packet>(std::move(raw_packet)); }
+#  endif
 inline bool is_packet_empty(packet_t& pkt) { return !pkt; }
 inline io_packet& forward_packet(packet_t& pkt) { return *pkt; }
 inline io_packet&& forward_packet(packet_t&& pkt) { return std::move(*pkt); }
@@ -835,14 +1179,31 @@ public:
 #endif
   }
   io_event(int cidx, int kind, int status, io_transport* source /*not nullable*/)
-      : kind_(kind), writable_(1), passive_(0), status_(status), cindex_(cidx), source_id_(source->id_), source_(source)
+      : kind_(kind), writable_(1), passive_(0), status_(status), cindex_(cidx), source_id_(source->id_), source_(source), transport_key_(source->key())
   {
 #if !defined(YASIO_MINIFY_EVENT)
     source_ud_ = source_->ud_.ptr;
 #endif
   }
   io_event(int cidx, io_packet&& pkt, io_transport* source /*not nullable*/)
-      : kind_(YEK_ON_PACKET), writable_(1), passive_(0), status_(0), cindex_(cidx), source_id_(source->id_), source_(source), packet_(wrap_packet(pkt))
+      : kind_(YEK_ON_PACKET), writable_(1), passive_(0), status_(0), cindex_(cidx), source_id_(source->id_), source_(source), transport_key_(source->key()),
+        packet_(wrap_packet(pkt))
+  {
+#if !defined(YASIO_MINIFY_EVENT)
+    source_ud_ = source_->ud_.ptr;
+#endif
+  }
+  io_event(int cidx, int kind, int status, io_packet&& pkt, io_transport* source /*not nullable*/)
+      : kind_(kind), writable_(1), passive_(0), status_(status), cindex_(cidx), source_id_(source->id_), source_(source), transport_key_(source->key()),
+        packet_(wrap_packet(pkt))
+  {
+#if !defined(YASIO_MINIFY_EVENT)
+    source_ud_ = source_->ud_.ptr;
+#endif
+  }
+  io_event(int cidx, io_packet_view&& view, io_transport* source /*not nullable*/)
+      : kind_(YEK_ON_PACKET), writable_(1), passive_(0), status_(0), cindex_(cidx), source_id_(source->id_), source_(source), transport_key_(source->key()),
+        packet_view_(std::move(view))
   {
 #if !defined(YASIO_MINIFY_EVENT)
     source_ud_ = source_->ud_.ptr;
@@ -850,7 +1211,13 @@ public:
   }
   io_event(const io_event&) = delete;
   io_event(io_event&& rhs)  = delete;
-  ~io_event() {}
+  ~io_event()
+  {
+#if !defined(YASIO_DISABLE_PACKET_POOL) && !defined(YASIO_USE_SHARED_PACKET)
+    // recycle the packet buffer if application didn't take it away
+    packet_pool::instance().release(packet_);
+#endif
+  }
 
 public:
   int cindex() const { return cindex_; }
@@ -863,8 +1230,14 @@ public:
 
   packet_t& packet() { return packet_; }
 
+  // The frame received by channel with YCF_PACKET_VIEW, the packet() is empty for such event
+  io_packet_view& packet_view() { return packet_view_; }
+
   /*[nullable]*/ transport_handle_t transport() const { return writable_ ? static_cast<transport_handle_t>(source_) : nullptr; }
 
+  // The generational handle of transport, safe to keep and write after the event deferred, 0 for channel event
+  transport_key_t transport_key() const { return transport_key_; }
+
   io_base* source() const { return source_; }
   unsigned int source_id() const { return source_id_; }
 
@@ -896,7 +1269,9 @@ private:
   unsigned int source_id_;
 
   io_base* source_;
+  transport_key_t transport_key_ = 0;
   packet_t packet_;
+  io_packet_view packet_view_;
 #if !defined(YASIO_MINIFY_EVENT)
   void* source_ud_;
   highp_time_t timestamp_ = highp_clock();
@@ -987,6 +1362,28 @@ public:
   }
   YASIO__DECL int write(transport_handle_t thandle, std::vector<char> buffer, completion_cb_t completion_handler = nullptr);
 
+  /*
+  ** Summary: Write the shared buffer to a transport without copy, the buffer can be written to
+  **          many transports, such as broadcast the same message to many clients
+  ** @remark: The buffer must not be modified after write
+  */
+  YASIO__DECL int write(transport_handle_t thandle, shared_buffer_t buffer, completion_cb_t completion_handler = nullptr);
+
+  /*
+  ** Summary: Write to the transport by generational handle, see io_transport::key
+  ** @retval: < 0: failed, the transport closed even the memory reused by new transport
+  */
+  YASIO__DECL int write(transport_key_t key, std::vector<char> buffer, completion_cb_t completion_handler = nullptr);
+  YASIO__DECL int write(transport_key_t key, shared_buffer_t buffer, completion_cb_t completion_handler = nullptr);
+
+  /*
+  ** Summary: Write the shared buffer to all transports of the channel, the transports are visited
+  **          at io_service thread, the buffer is shared by all send ops without copy
+  ** @retval: < 0: failed, otherwise the buffer size
+  ** @remark: The buffer must not be modified after broadcast
+  */
+  YASIO__DECL int broadcast(int cindex, shared_buffer_t buffer);
+
   /*
    ** Summary: Write data to unconnected UDP transport with specified address.
    ** @retval: < 0: failed
@@ -1008,19 +1405,20 @@ public:
   // Gets channel by index
   YASIO__DECL io_channel* channel_at(size_t index) const;
 
+  // Adds a channel at runtime, thread safe, returns the index of new channel, it's stable until the channel removed,
+  // and may be reused by later added channel
+  YASIO__DECL int add_channel(const io_hostent* ep = nullptr);
+  int add_channel(const io_hostent& ep) { return add_channel(&ep); }
+
+  // Removes a channel at runtime, thread safe, returns 0 if succeed, -1 if no channel at the index
+  // remark: the channel and its transports are closed without YEK_ON_CLOSE of channel, then destroyed by the service thread,
+  //         the io_event::source of the channel must not be accessed after that.
+  YASIO__DECL int remove_channel(int index);
+
 private:
   YASIO__DECL void schedule_timer(highp_timer*, timer_cb_t&&);
   YASIO__DECL void remove_timer(highp_timer*);
 
-  std::vector<timer_impl_t>::iterator find_timer(highp_timer* key)
-  {
-    return yasio__find_if(timer_queue_, [=](const timer_impl_t& timer) { return timer.first == key; });
-  }
-  void sort_timers()
-  {
-    std::sort(this->timer_queue_.begin(), this->timer_queue_.end(),
-              [](const timer_impl_t& lhs, const timer_impl_t& rhs) { return lhs.first->wait_duration() > rhs.first->wait_duration(); });
-  }
 
   // Start a async resolve, It's only for internal use
   YASIO__DECL void start_resolve(io_channel*);
@@ -1035,18 +1433,26 @@ private:
 
   YASIO__DECL void open_internal(io_channel*);
 
-  YASIO__DECL void process_transports(fd_set* fds_array);
-  YASIO__DECL void process_channels(fd_set* fds_array);
+  YASIO__DECL void process_transports();
+  YASIO__DECL void process_channels();
   YASIO__DECL void process_timers();
 
   YASIO__DECL void interrupt();
 
+  // Add transport to the active list, it will be processed at next loop, only call at io_service thread
+  YASIO__DECL void activate(transport_handle_t);
+  // Add transport to the wakeup list and interrupt the io_service, thread safe, the closed transport is ignored
+  YASIO__DECL void wakeup(transport_handle_t);
+  // Add/Remove transport to the transport list and slot table, O(1), only call at io_service thread
+  YASIO__DECL void insert_transport(transport_handle_t);
+  YASIO__DECL void remove_transport(transport_handle_t);
+
   YASIO__DECL highp_time_t get_timeout(highp_time_t usec);
 
-  YASIO__DECL int do_select(fd_set* fds_array, highp_time_t wait_duration);
+  YASIO__DECL int do_evpoll(highp_time_t wait_duration);
 
   YASIO__DECL void do_nonblocking_connect(io_channel*);
-  YASIO__DECL void do_nonblocking_connect_completion(io_channel*, fd_set* fds_array);
+  YASIO__DECL void do_nonblocking_connect_completion(io_channel*);
 
 #if defined(YASIO_SSL_BACKEND)
   YASIO__DECL void init_ssl_context();
@@ -1062,7 +1468,8 @@ private:
     if (ares_outstanding_work_ > 0)
       --ares_outstanding_work_;
   }
-  YASIO__DECL void process_ares_requests(fd_set* fds_array);
+  YASIO__DECL void register_ares_descriptors();
+  YASIO__DECL void process_ares_requests();
   YASIO__DECL void recreate_ares_channel();
   YASIO__DECL void config_ares_name_servers();
   YASIO__DECL void destroy_ares_channel();
@@ -1082,8 +1489,12 @@ private:
   // The major non-blocking event-loop
   YASIO__DECL void run(void);
 
-  YASIO__DECL bool do_read(transport_handle_t, fd_set* fds_array);
-  bool do_write(transport_handle_t transport) { return transport->do_write(this->wait_duration_); }
+  YASIO__DECL bool do_read(transport_handle_t);
+  // Flush the send queue and trigger the watermark events
+  YASIO__DECL bool do_write(transport_handle_t);
+
+  // Reserve the send queue bytes before write, returns false if the write should be rejected by limit
+  YASIO__DECL bool reserve_write(transport_handle_t, size_t size);
   YASIO__DECL void unpack(transport_handle_t, int bytes_expected, int bytes_transferred, int bytes_to_strip);
 
   // The op mask will be cleared, the state will be set CLOSED when clear_state is 'true'
@@ -1094,9 +1505,12 @@ private:
   YASIO__DECL void handle_event(event_ptr event);
 
   // new/delete client socket connection channel
-  // please call this at initialization, don't new channel at runtime
-  // dynmaically: because this API is not thread safe.
+  // please call this at initialization, use add_channel to new channel at runtime
   YASIO__DECL void create_channels(const io_hostent* eps, int count);
+  // Destroy the removed channels which are ready at service thread
+  YASIO__DECL void process_removed_channels();
+  // Close the channel and its transports, returns true when it can be destroyed safely
+  YASIO__DECL bool try_release_channel(io_channel*);
   // Clear all channels after service exit.
   YASIO__DECL void clear_channels();   // destroy all channels
   YASIO__DECL void clear_transports(); // destroy all transports
@@ -1115,7 +1529,7 @@ private:
 
   // supporting server
   YASIO__DECL void do_nonblocking_accept(io_channel*);
-  YASIO__DECL void do_nonblocking_accept_completion(io_channel*, fd_set* fds_array);
+  YASIO__DECL void do_nonblocking_accept_completion(io_channel*);
 
   YASIO__DECL static const char* strerror(int error);
 
@@ -1124,6 +1538,20 @@ private:
   */
   YASIO__DECL transport_handle_t do_dgram_accept(io_channel*, const ip::endpoint& peer, int& error);
 
+  /*
+  ** Summary: For udp-server only, dispatch a datagram received by channel to the transport of peer,
+  **          make new one if transport is nullptr, returns the transport which handled the datagram
+  */
+  YASIO__DECL transport_handle_t handle_dgram(io_channel*, const ip::endpoint& peer, const char* data, int n, transport_handle_t transport);
+
+#if defined(__linux__)
+  /*
+  ** Summary: Receive datagrams with recvmmsg into dgram_batch_
+  ** returns: the datagrams count received, 0: would block, -1: error occurred
+  */
+  YASIO__DECL int recv_dgram_batch(xxsocket* sock, int& error);
+#endif
+
   int local_address_family() const { return ((ipsv_ & ipsv_ipv4) || !ipsv_) ? AF_INET : AF_INET6; }
 
   /* For log macro only */
@@ -1136,7 +1564,12 @@ private:
 
   privacy::concurrent_queue<event_ptr, true> events_;
 
+  // The channel slots, the slot of removed channel is nullptr until reused by add_channel
+  mutable std::recursive_mutex channels_mtx_;
   std::vector<io_channel*> channels_;
+  std::vector<int> free_slots_;
+  std::vector<io_channel*> removed_channels_;
+  std::atomic<bool> reap_channels_{false};
 
   std::recursive_mutex channel_ops_mtx_;
   std::vector<io_channel*> channel_ops_;
@@ -1144,26 +1577,79 @@ private:
   std::vector<transport_handle_t> transports_;
   std::vector<transport_handle_t> tpool_;
 
+  // The transport table indexed by slot of transport_key_t, the free slots are reused with next generation,
+  // modify at io_service thread and lookup by user thread
+  struct io_transport_slot {
+    transport_handle_t transport;
+    uint32_t generation;
+  };
+  std::recursive_mutex tslots_mtx_;
+  std::vector<io_transport_slot> tslots_;
+  std::vector<uint32_t> free_tslots_;
+
+  // the transports have readiness, pending send ops or unconsumed frames, process at next loop
+  std::vector<transport_handle_t> active_transports_;
+  std::vector<transport_handle_t> processing_transports_;
+  std::unordered_map<socket_native_type, transport_handle_t> fd_transports_;
+
+  // the transports woken up by write or close requests, queued by key, the stale ones are dropped
+  std::recursive_mutex wakeup_mtx_;
+  std::vector<transport_key_t> wakeup_transports_;
+  std::vector<transport_key_t> processing_wakeups_;
+  std::atomic<bool> wakeup_requested_{false};
+
+  // the channel open/close requests affect all transports of the channel
+  std::atomic<bool> rescan_transports_{false};
+
+  // the broadcast requests, fan out to transports at io_service thread
+  std::recursive_mutex broadcast_mtx_;
+  std::vector<std::pair<int, shared_buffer_t>> broadcast_ops_;
+  std::atomic<bool> broadcast_requested_{false};
+
+  // the gather buffers of transport send, only access at io_service thread
+  std::vector<iobuf> iobufs_;
+
+#if defined(__linux__)
+  // the buffers of udp batch io, only access at io_service thread
+  struct __unnamed_dgram_batch {
+    struct dgram {
+      const char* data;
+      int size;
+      int peer; // the index of peers_
+    };
+    std::vector<mmsghdr> recv_hdrs_;
+    std::vector<iovec> recv_bufs_;
+    std::vector<ip::endpoint> peers_;
+    std::vector<char> data_;
+    std::vector<char> cmsgs_;                    // the control messages to retrive segment size of UDP_GRO
+    std::vector<dgram> dgrams_;                  // the received datagrams, the coalesced ones are split
+    std::vector<transport_handle_t> transports_; // the transports handled the datagrams of server channel
+    int count_ = 0; // the received datagrams count
+    int index_ = 0; // the next datagram to read
+
+    std::vector<mmsghdr> send_hdrs_;
+  } dgram_batch_;
+#endif
+#if defined(YASIO_ENABLE_SHARED_RECV_BUFFER)
+  // The recv buffer shared by all transports, the second half is the raw buffer of kcp
+  std::vector<char> recv_buffer_;
+#endif
+
   // select interrupter
   select_interrupter interrupter_;
 
-  // timer support timer_pair
-  std::vector<timer_impl_t> timer_queue_;
+  // timer support, the tick of timing wheel is YASIO_TIMER_WHEEL_RESOLUTION
+  timing_wheel timer_wheel_;
   std::recursive_mutex timer_queue_mtx_;
 
-  // the next wait duration for socket.select
+  // the cached time of current loop, in microseconds
+  highp_time_t now_ = 0;
+
+  // the next wait duration for io_watcher.poll_io
   highp_time_t wait_duration_;
 
-  // the max nfds for socket.select, must be max_fd + 1
-  int max_nfds_;
-  enum
-  {
-    read_op,
-    write_op,
-    except_op,
-    max_ops,
-  };
-  fd_set fds_array_[max_ops];
+  // the io watcher: epoll on linux, select on other platforms
+  io_watcher io_watcher_;
 
   // options
   struct __unnamed_options {
@@ -1187,6 +1673,19 @@ private:
 
     bool no_new_thread_ = false;
 
+    // udp batch io size, linux only
+    int udp_recv_batch_ = 8;
+    int udp_send_batch_ = 8;
+
+    // tcp zero-copy send threshold, linux only
+    int zerocopy_threshold_ = 0;
+
+    // max tcp connections accepted per server channel per loop iteration
+    int accept_budget_ = YASIO_ACCEPT_BUDGET;
+
+    // max bytes read per tcp transport per loop iteration
+    int read_budget_ = YASIO_READ_BUDGET;
+
     // The resolve function
     resolv_fn_t resolv_;
     // the event callback
@@ -1208,6 +1707,8 @@ private:
 #if defined(YASIO_HAVE_CARES)
   ares_channel ares_         = nullptr; // the ares handle for non blocking io dns resolve support
   int ares_outstanding_work_ = 0;
+  // the descriptors of c-ares registered to io_watcher at current loop
+  std::vector<std::pair<socket_native_type, int>> ares_fds_;
 #else
   // we need life_token + life_mutex
   struct life_token {};
@@ -1216,6 +1717,67 @@ private:
 #endif
 }; // io_service
 
+/*
+** Summary: The multi-threaded io_service group, runs N io_service loops with the same channel settings
+** @remark:
+**   a. The server channels are opened at every loop with YCF_REUSEADDR, on linux the SO_REUSEPORT
+**      listeners make the kernel spread accepts across loops, other platforms only the first loop
+**      opens server channels.
+**   b. The client channels are opened at the first loop, use service_at to open at other loop.
+**   c. All loops share the same event callback, it's invoked at the io_service thread which owns
+**      the event source if YOPT_S_DEFERRED_EVENT is 0, otherwise at the io_service_group::dispatch caller thread.
+**   d. YOPT_S_NO_NEW_THREAD is not supported.
+*/
+class YASIO_API io_service_group {
+public:
+  // @params: concurrency: the number of loops, <= 0: std::thread::hardware_concurrency
+  YASIO__DECL io_service_group(int concurrency, const io_hostent* channel_eps /* could be nullptr */, int channel_count);
+  io_service_group(int concurrency, const io_hostent& channel_ep) : io_service_group(concurrency, &channel_ep, 1) {}
+  io_service_group(int concurrency, int channel_count) : io_service_group(concurrency, nullptr, channel_count) {}
+  YASIO__DECL ~io_service_group();
+
+  YASIO__DECL void start(event_cb_t cb);
+  YASIO__DECL void stop();
+
+  // dispatch events of all loops, the max_count is per loop
+  YASIO__DECL void dispatch(int max_count = 128);
+
+  // set option to all loops, the transport or io_base options only apply once
+  YASIO__DECL void set_option(int opt, ...);
+  YASIO__DECL void set_option_internal(int opt, va_list args);
+
+  YASIO__DECL void open(size_t index, int kind = YCK_TCP_CLIENT);
+  YASIO__DECL void close(int index);
+
+  // the transport APIs, route to the owning loop of the transport
+  bool is_open(transport_handle_t thandle) const { return thandle && thandle->get_context()->get_service().is_open(thandle); }
+  void close(transport_handle_t thandle)
+  {
+    if (thandle)
+      thandle->get_context()->get_service().close(thandle);
+  }
+  int write(transport_handle_t thandle, const void* buf, size_t len, completion_cb_t completion_handler = nullptr)
+  {
+    return write(thandle, std::vector<char>((char*)buf, (char*)buf + len), std::move(completion_handler));
+  }
+  YASIO__DECL int write(transport_handle_t thandle, std::vector<char> buffer, completion_cb_t completion_handler = nullptr);
+  YASIO__DECL int write(transport_handle_t thandle, shared_buffer_t buffer, completion_cb_t completion_handler = nullptr);
+  int write_to(transport_handle_t thandle, const void* buf, size_t len, const ip::endpoint& to, completion_cb_t completion_handler = nullptr)
+  {
+    return write_to(thandle, std::vector<char>((char*)buf, (char*)buf + len), to, std::move(completion_handler));
+  }
+  YASIO__DECL int write_to(transport_handle_t thandle, std::vector<char> buffer, const ip::endpoint& to, completion_cb_t completion_handler = nullptr);
+
+  // broadcast the shared buffer to the channel transports of all loops
+  YASIO__DECL int broadcast(int cindex, shared_buffer_t buffer);
+
+  size_t size() const { return services_.size(); }
+  io_service* service_at(size_t index) const { return index < services_.size() ? services_[index].get() : nullptr; }
+
+private:
+  std::vector<std::unique_ptr<io_service>> services_;
+}; // io_service_group
+
 } // namespace inet
 #if !YASIO__HAS_NS_INLINE
 using namespace yasio::inet;